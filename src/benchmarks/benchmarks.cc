@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../btree/b_plus_tree.h"
+#include "../concurrent/concurrent_b_plus_tree.h"
+#include "../concurrent/concurrent_hash_table.h"
+#include "../hashtable/hash_table.h"
+#include "../sharded/sharded_key_value.h"
+#include "../tree/self_balancing_binary_search_tree.h"
+
+// Замеры производительности хранилищ: make bench [ARGS="число фильтр"].
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Benchmark {
+  std::string name;
+  std::function<void(size_t n)> run;
+};
+
+auto MakePeer(const std::string &key, size_t i) -> Peer {
+  return {key, "Ivanov", "Ivan", 1950 + static_cast<int>(i % 60), "Omsk",
+          static_cast<int>(i % 1000)};
+}
+
+auto SequentialKeys(size_t n) -> std::vector<std::string> {
+  std::vector<std::string> keys;
+  keys.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    std::string key = std::to_string(i);
+    keys.push_back(std::string(9 - key.size(), '0') + key);
+  }
+  return keys;
+}
+
+auto RandomKeys(size_t n) -> std::vector<std::string> {
+  auto keys = SequentialKeys(n);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+  return keys;
+}
+
+auto Report(const std::string &name, size_t ops, Clock::time_point start)
+    -> void {
+  double seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  std::cout << std::left << std::setw(36) << name << std::right
+            << std::setw(10) << ops << " ops " << std::setw(10)
+            << std::fixed << std::setprecision(3) << seconds << " s "
+            << std::setw(14) << std::setprecision(0) << ops / seconds
+            << " ops/s" << std::endl;
+}
+
+template <typename Storage>
+auto InsertThenErase(const std::string &name,
+                     const std::vector<std::string> &keys) -> void {
+  Storage storage;
+  auto start = Clock::now();
+  for (size_t i = 0; i < keys.size(); ++i) storage.Set(MakePeer(keys[i], i));
+  Report(name + " insert", keys.size(), start);
+  start = Clock::now();
+  for (const auto &key : keys) storage.Exists(key);
+  Report(name + " lookup", keys.size(), start);
+  start = Clock::now();
+  size_t listed = storage.Keys().size();
+  Report(name + " keys", listed, start);
+  start = Clock::now();
+  for (const auto &key : keys) storage.Del(key);
+  Report(name + " erase", keys.size(), start);
+}
+
+// Заполнение и уничтожение целого хранилища без поштучного удаления.
+template <typename Storage>
+auto InsertThenDestroy(const std::string &name,
+                       const std::vector<std::string> &keys) -> void {
+  auto storage = std::make_unique<Storage>();
+  for (size_t i = 0; i < keys.size(); ++i) storage->Set(MakePeer(keys[i], i));
+  auto start = Clock::now();
+  storage.reset();
+  Report(name + " destroy", keys.size(), start);
+}
+
+// Переименование каждого ключа хранилища.
+template <typename Storage>
+auto InsertThenRename(const std::string &name,
+                      const std::vector<std::string> &keys) -> void {
+  Storage storage;
+  for (size_t i = 0; i < keys.size(); ++i) storage.Set(MakePeer(keys[i], i));
+  auto start = Clock::now();
+  for (const auto &key : keys) storage.Rename(key, "r" + key);
+  Report(name + " rename", keys.size(), start);
+}
+
+// Выгрузка в файл и загрузка выгруженного файла в пустое хранилище.
+template <typename Storage>
+auto ExportThenUpload(const std::string &name,
+                      const std::vector<std::string> &keys) -> void {
+  const std::string path = "bench_export.dat";
+  {
+    Storage storage;
+    for (size_t i = 0; i < keys.size(); ++i)
+      storage.Set(MakePeer(keys[i], i));
+    auto start = Clock::now();
+    storage.ExportData(path);
+    Report(name + " export", keys.size(), start);
+  }
+  Storage storage;
+  auto start = Clock::now();
+  storage.Upload(path);
+  Report(name + " upload", keys.size(), start);
+  std::remove(path.c_str());
+}
+
+// Смешанная нагрузка из нескольких потоков: каждая write_every-я операция -
+// Update, остальные - GetCopy.
+template <typename Make>
+auto MixedLoad(const std::string &name, Make make,
+               const std::vector<std::string> &keys, size_t write_every)
+    -> void {
+  for (size_t threads : {1, 2, 4, 8, 16}) {
+    std::unique_ptr<KeyValue> storage = make();
+    for (size_t i = 0; i < keys.size(); ++i) storage->Set(MakePeer(keys[i], i));
+    std::vector<std::thread> workers;
+    auto start = Clock::now();
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&storage, &keys, t, threads, write_every] {
+        std::mt19937_64 gen(t);
+        Peer peer;
+        for (size_t i = t; i < keys.size(); i += threads) {
+          const std::string &key = keys[gen() % keys.size()];
+          if (i % write_every == 0) {
+            storage->Update(key, "", "", 0, "", static_cast<int>(i));
+          } else {
+            storage->GetCopy(key, &peer);
+          }
+        }
+      });
+    }
+    for (auto &worker : workers) worker.join();
+    Report(name + " x" + std::to_string(threads), keys.size(), start);
+  }
+}
+
+// Полные обходы Find и Keys последовательно и частями в WorkerPool.
+template <typename Storage>
+auto ParallelScan(const std::string &name, const std::vector<std::string> &keys)
+    -> void {
+  Storage storage;
+  for (size_t i = 0; i < keys.size(); ++i) storage.Set(MakePeer(keys[i], i));
+  for (size_t parts : {size_t{1}, s21::WorkerCount()}) {
+    storage.SetParallelScan(parts);
+    std::string suffix = " x" + std::to_string(parts);
+    auto start = Clock::now();
+    storage.Find("", "", 1990, "", -1);
+    Report(name + " find" + suffix, keys.size(), start);
+    start = Clock::now();
+    storage.Keys();
+    Report(name + " keys" + suffix, keys.size(), start);
+  }
+}
+
+auto MakeSharded() -> std::unique_ptr<KeyValue> {
+  return std::make_unique<s21::ShardedKeyValue>(
+      [] { return std::make_unique<s21::HashTable>(); });
+}
+
+auto MakeConcurrent() -> std::unique_ptr<KeyValue> {
+  return std::make_unique<s21::ConcurrentHashTable>();
+}
+
+auto MakeConcurrentTree() -> std::unique_ptr<KeyValue> {
+  return std::make_unique<s21::ConcurrentBPlusTree>();
+}
+
+auto Benchmarks() -> std::vector<Benchmark> {
+  return {
+      {"tree_sequential",
+       [](size_t n) {
+         InsertThenErase<s21::SelfBalancingBinarySearchTree>(
+             "tree sequential", SequentialKeys(n));
+       }},
+      {"tree_random",
+       [](size_t n) {
+         InsertThenErase<s21::SelfBalancingBinarySearchTree>("tree random",
+                                                            RandomKeys(n));
+       }},
+      {"btree_sequential",
+       [](size_t n) {
+         InsertThenErase<s21::BPlusTree>("btree sequential",
+                                         SequentialKeys(n));
+       }},
+      {"btree_random",
+       [](size_t n) {
+         InsertThenErase<s21::BPlusTree>("btree random", RandomKeys(n));
+       }},
+      {"hash_random",
+       [](size_t n) {
+         InsertThenErase<s21::HashTable>("hash random", RandomKeys(n));
+       }},
+      {"sharded",
+       [](size_t n) {
+         MixedLoad("sharded mixed", MakeSharded, RandomKeys(n), 10);
+       }},
+      {"concurrent",
+       [](size_t n) {
+         auto keys = RandomKeys(n);
+         MixedLoad("sharded 95/5", MakeSharded, keys, 20);
+         MixedLoad("concurrent 95/5", MakeConcurrent, keys, 20);
+         MixedLoad("concurrent btree 95/5", MakeConcurrentTree, keys, 20);
+       }},
+      {"rename",
+       [](size_t n) {
+         auto keys = RandomKeys(n);
+         InsertThenRename<s21::SelfBalancingBinarySearchTree>("tree", keys);
+         InsertThenRename<s21::BPlusTree>("btree", keys);
+         InsertThenRename<s21::HashTable>("hash", keys);
+       }},
+      {"upload",
+       [](size_t n) {
+         auto keys = RandomKeys(n);
+         ExportThenUpload<s21::SelfBalancingBinarySearchTree>("tree", keys);
+         ExportThenUpload<s21::BPlusTree>("btree", keys);
+         ExportThenUpload<s21::HashTable>("hash", keys);
+         ExportThenUpload<s21::ConcurrentHashTable>("concurrent", keys);
+         ExportThenUpload<s21::ConcurrentBPlusTree>("concurrent btree", keys);
+       }},
+      {"scan",
+       [](size_t n) {
+         auto keys = RandomKeys(n);
+         ParallelScan<s21::SelfBalancingBinarySearchTree>("tree", keys);
+         ParallelScan<s21::BPlusTree>("btree", keys);
+         ParallelScan<s21::HashTable>("hash", keys);
+       }},
+      {"destroy",
+       [](size_t n) {
+         auto keys = RandomKeys(n);
+         InsertThenDestroy<s21::SelfBalancingBinarySearchTree>("tree", keys);
+         InsertThenDestroy<s21::BPlusTree>("btree", keys);
+         InsertThenDestroy<s21::HashTable>("hash", keys);
+       }},
+  };
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  std::string filter = argc > 2 ? argv[2] : "";
+  for (const Benchmark &benchmark : Benchmarks()) {
+    if (benchmark.name.find(filter) == std::string::npos) continue;
+    benchmark.run(n);
+  }
+  return 0;
+}
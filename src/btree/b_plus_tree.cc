@@ -0,0 +1,359 @@
+#include "b_plus_tree.h"
+
+#include <algorithm>
+
+#include "../other/record_loader.h"
+
+namespace s21 {
+
+BPlusTree::BPlusTree() {
+  first_leaf_ = last_leaf_ = leaves_.New();
+  root_ = first_leaf_;
+}
+
+// Узлы не обходятся: пулы уничтожают их подряд по плитам.
+BPlusTree::~BPlusTree() {
+  inners_.Clear();
+  leaves_.Clear();
+}
+
+auto BPlusTree::Set(Peer peer, int time_of_life) -> void {
+  Tick();
+  bool inserted = false;
+  Position pos = Insert(std::move(peer), &inserted);
+  if (!inserted) {
+    if (!Expirer::Expired(pos.record().deadline, Expirer::NowMs())) return;
+    EraseAt(pos);
+    pos = Insert(std::move(peer), &inserted);
+  }
+  Track(pos.record().peer);
+  if (time_of_life > 0)
+    SetDeadline(pos, Expirer::NowMs() + time_of_life * 1000LL);
+}
+
+auto BPlusTree::Get(const std::string &key) -> Peer * {
+  Tick();
+  Position pos = LocateLive(key);
+  return pos ? &pos.record().peer : nullptr;
+}
+
+auto BPlusTree::Exists(const std::string &key) -> bool {
+  Tick();
+  return static_cast<bool>(LocateLive(key));
+}
+
+// Удаление за один спуск: путь до листа сохраняется для балансировки.
+auto BPlusTree::Del(const std::string &key) -> bool {
+  Tick();
+  Path path;
+  Leaf *leaf = Descend(key, &path);
+  int i = LowerBound(leaf, key);
+  if (i == leaf->count || !leaf->records[i].peer.key.Equals(key))
+    return false;
+  bool live = !Expirer::Expired(leaf->records[i].deadline, Expirer::NowMs());
+  Untrack(leaf->records[i].peer);
+  RemoveAt(&path, leaf, i, nullptr);
+  return live;
+}
+
+auto BPlusTree::Update(const std::string &key, const std::string &last_name,
+                       const std::string &first_name, int year_of_birth,
+                       const std::string &city, int number_of_current_coins)
+    -> void {
+  Tick();
+  Position pos = LocateLive(key);
+  if (pos) {
+    Peer &peer = pos.record().peer;
+    Untrack(peer);
+    if (!last_name.empty()) peer.last_name = last_name;
+    if (!first_name.empty()) peer.first_name = first_name;
+    if (year_of_birth) peer.year_of_birth = year_of_birth;
+    if (!city.empty()) peer.city = city;
+    peer.number_of_current_coins = number_of_current_coins;
+    Track(peer);
+  }
+}
+
+// Обходит живые записи по возрастанию ключа по списку листьев.
+template <typename Func>
+auto BPlusTree::ForEach(Func func) -> void {
+  int64_t now = Expirer::NowMs();
+  for (Leaf *leaf = first_leaf_; leaf; leaf = leaf->next) {
+    for (int i = 0; i < leaf->count; ++i) {
+      Record &record = leaf->records[i];
+      if (!Expirer::Expired(record.deadline, now)) func(record.peer);
+    }
+  }
+}
+
+// Полный обход, разделённый на отрезки списка листьев. Отрезки начинаются
+// с самых левых листьев поддеревьев первого уровня, где узлов не меньше,
+// чем частей: все листья на одной глубине, а узлы заполнены хотя бы
+// наполовину, поэтому отрезки близки по размеру. func(peer, &out)
+// добавляет результаты записи в вектор своего отрезка.
+template <typename T, typename Func>
+auto BPlusTree::Collect(Func func) -> std::vector<T> {
+  size_t parts = std::clamp<size_t>(size_ / kMinScanPart, 1, scan_parts_);
+  std::vector<Node *> level{root_};
+  while (level.size() < parts && !level.front()->leaf) {
+    std::vector<Node *> below;
+    for (Node *node : level) {
+      auto *inner = static_cast<Inner *>(node);
+      below.insert(below.end(), inner->children.begin(),
+                   inner->children.begin() + inner->count + 1);
+    }
+    level = std::move(below);
+  }
+  parts = std::min(parts, level.size());
+  std::vector<Leaf *> bounds;
+  for (size_t part = 0; part < parts; ++part) {
+    Node *node = level[level.size() * part / parts];
+    while (!node->leaf) node = static_cast<Inner *>(node)->children[0];
+    bounds.push_back(static_cast<Leaf *>(node));
+  }
+  bounds.push_back(nullptr);
+  int64_t now = Expirer::NowMs();
+  return WorkerPool::Instance().Gather<T>(
+      parts, [&bounds, now, &func](size_t part, std::vector<T> *out) {
+        for (Leaf *leaf = bounds[part]; leaf != bounds[part + 1];
+             leaf = leaf->next) {
+          for (int i = 0; i < leaf->count; ++i) {
+            Record &record = leaf->records[i];
+            if (!Expirer::Expired(record.deadline, now))
+              func(record.peer, out);
+          }
+        }
+      });
+}
+
+auto BPlusTree::Keys() -> std::vector<std::string> {
+  Tick();
+  return Collect<std::string>([](Peer &peer, std::vector<std::string> *out) {
+    out->push_back(peer.key);
+  });
+}
+
+// Запись перемещается в лист нового ключа вместе со сроком жизни. Живая
+// запись с ключом key_new заменяется, как RENAME в Redis.
+auto BPlusTree::Rename(const std::string &key_old, const std::string &key_new)
+    -> void {
+  Tick();
+  if (key_old == key_new || !LocateLive(key_old)) return;
+  if (Position target = LocateLive(key_new)) EraseAt(target);
+  Position pos = Locate(key_old);
+  Untrack(pos.record().peer);
+  Record record;
+  Unlink(key_old, &record);
+  record.peer.key = key_new;
+  bool inserted = false;
+  Position dst = Insert(std::move(record.peer), &inserted);
+  Track(dst.record().peer);
+  SetDeadline(dst, record.deadline);
+}
+
+auto BPlusTree::TTL(const std::string &key) -> int {
+  Tick();
+  Position pos = LocateLive(key);
+  if (!pos || !pos.record().deadline) return 0;
+  return static_cast<int>(
+      (pos.record().deadline - Expirer::NowMs() + 999) / 1000);
+}
+
+auto BPlusTree::Expire(const std::string &key, int seconds) -> bool {
+  return PExpireAt(key, Expirer::NowMs() + std::max(seconds, 0) * 1000LL);
+}
+
+auto BPlusTree::Persist(const std::string &key) -> bool {
+  Tick();
+  Position pos = LocateLive(key);
+  if (!pos || !pos.record().deadline) return false;
+  SetDeadline(pos, 0);
+  return true;
+}
+
+auto BPlusTree::PTTL(const std::string &key) -> int64_t {
+  Tick();
+  Position pos = LocateLive(key);
+  if (!pos) return -2;
+  if (!pos.record().deadline) return -1;
+  return std::max<int64_t>(0, pos.record().deadline - Expirer::NowMs());
+}
+
+auto BPlusTree::PExpireTime(const std::string &key) -> int64_t {
+  Tick();
+  Position pos = LocateLive(key);
+  if (!pos) return -2;
+  return pos.record().deadline ? pos.record().deadline : -1;
+}
+
+auto BPlusTree::PExpireAt(const std::string &key, int64_t deadline) -> bool {
+  Tick();
+  Position pos = LocateLive(key);
+  if (!pos) return false;
+  if (Expirer::Expired(deadline, Expirer::NowMs())) {
+    EraseAt(pos);
+  } else {
+    SetDeadline(pos, deadline);
+  }
+  return true;
+}
+
+auto BPlusTree::Find(const std::string &last_name,
+                     const std::string &first_name, int year_of_birth,
+                     const std::string &city, int number_of_current_coins)
+    -> std::vector<std::string> {
+  Tick();
+  std::vector<std::string> result;
+  PeerFilter filter(last_name, first_name, year_of_birth, city,
+                    number_of_current_coins);
+  if (filter.Selective() && (indexing_ || columnar_)) {
+    auto candidates =
+        indexing_ ? index_.Find(filter) : columns_.Find(filter);
+    for (const std::string &key : candidates) {
+      if (LocateLive(key)) result.push_back(key);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+  if (filter.Impossible()) return result;
+  return Collect<std::string>(
+      [&filter](Peer &peer, std::vector<std::string> *out) {
+        if (filter(peer)) out->push_back(peer.key);
+      });
+}
+
+auto BPlusTree::SetIndexing(bool enable) -> bool {
+  indexing_ = enable;
+  index_.Clear();
+  if (enable) ForEach([this](const Peer &peer) { index_.Insert(peer); });
+  return true;
+}
+
+auto BPlusTree::SetColumnar(bool enable) -> bool {
+  columnar_ = enable;
+  columns_.Clear();
+  if (enable) ForEach([this](const Peer &peer) { columns_.Insert(peer); });
+  return true;
+}
+
+auto BPlusTree::SetParallelScan(size_t parts) -> bool {
+  scan_parts_ = parts ? parts : WorkerCount();
+  return true;
+}
+
+auto BPlusTree::ShowAll() -> std::vector<Peer *> {
+  Tick();
+  return Collect<Peer *>(
+      [](Peer &peer, std::vector<Peer *> *out) { out->push_back(&peer); });
+}
+
+auto BPlusTree::ScanRange(const std::string &from, const std::string &to,
+                          const Visitor &visit, bool reverse) -> void {
+  Tick();
+  int64_t now = Expirer::NowMs();
+  if (reverse) {
+    for (Position pos = SeekBefore(to); pos;) {
+      Record &record = pos.record();
+      if (record.peer.key.Compare(from) < 0) break;
+      if (!Expirer::Expired(record.deadline, now) && !visit(record.peer))
+        break;
+      if (--pos.index < 0) {
+        pos.leaf = pos.leaf->prev;
+        pos.index = pos.leaf ? pos.leaf->count - 1 : 0;
+      }
+    }
+  } else {
+    for (Position pos = Seek(from); pos;) {
+      Record &record = pos.record();
+      if (!to.empty() && record.peer.key.Compare(to) >= 0) break;
+      if (!Expirer::Expired(record.deadline, now) && !visit(record.peer))
+        break;
+      if (++pos.index == pos.leaf->count) {
+        pos.leaf = pos.leaf->next;
+        pos.index = 0;
+      }
+    }
+  }
+}
+
+auto BPlusTree::ActiveExpireCycle(std::chrono::microseconds budget)
+    -> size_t {
+  return expiry_.Cycle(
+      [this](const std::string &key, int64_t deadline) {
+        return Reclaim(key, deadline);
+      },
+      budget);
+}
+
+auto BPlusTree::Upload(const std::string &data_directory) -> int {
+  Tick();
+  auto batches = ParseRecords(data_directory);
+  for (auto &batch : batches) {
+    for (Peer &peer : batch) Set(std::move(peer));
+  }
+  return RecordCount(batches);
+}
+
+auto BPlusTree::ExportData(const std::string &data_directory) -> int {
+  Tick();
+  std::ofstream file(data_directory);
+  int lines = 0;
+  if (file.is_open()) {
+    ForEach([&file, &lines](const Peer &peer) {
+      file << peer.key << " ";
+      file << peer.last_name << " ";
+      file << peer.first_name << " ";
+      file << peer.year_of_birth << " ";
+      file << peer.city << " ";
+      file << peer.number_of_current_coins << "\n";
+      ++lines;
+    });
+  }
+  return lines;
+}
+
+auto BPlusTree::LocateLive(std::string_view key) -> Position {
+  Position pos = Locate(key);
+  if (pos && Expirer::Expired(pos.record().deadline, Expirer::NowMs())) {
+    EraseAt(pos);
+    return {nullptr, 0};
+  }
+  return pos;
+}
+
+// Ключ копируется: записи листа сдвигаются при удалении.
+auto BPlusTree::EraseAt(const Position &pos) -> void {
+  Untrack(pos.record().peer);
+  std::string key = pos.record().peer.key;
+  Unlink(key);
+}
+
+auto BPlusTree::SetDeadline(const Position &pos, int64_t deadline) -> void {
+  pos.record().deadline = deadline;
+  expiry_.Schedule(pos.record().peer.key, deadline);
+}
+
+auto BPlusTree::Track(const Peer &peer) -> void {
+  if (indexing_) index_.Insert(peer);
+  if (columnar_) columns_.Insert(peer);
+}
+
+auto BPlusTree::Untrack(const Peer &peer) -> void {
+  if (indexing_) index_.Erase(peer);
+  if (columnar_) columns_.Erase(peer.key);
+}
+
+auto BPlusTree::Reclaim(const std::string &key, int64_t deadline) -> bool {
+  Position pos = Locate(key);
+  if (!pos || pos.record().deadline != deadline) return false;
+  EraseAt(pos);
+  return true;
+}
+
+auto BPlusTree::Tick() -> void {
+  expiry_.Tick([this](const std::string &key, int64_t deadline) {
+    return Reclaim(key, deadline);
+  });
+}
+
+}  // namespace s21
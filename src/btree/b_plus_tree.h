@@ -0,0 +1,293 @@
+#ifndef A6_B_PLUS_TREE_H
+#define A6_B_PLUS_TREE_H
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+#include "../expiration/expirer.h"
+#include "../index/column_store.h"
+#include "../index/secondary_index.h"
+#include "../other/key_value.h"
+#include "../other/node_pool.h"
+#include "../other/ordered_key_value.h"
+#include "../other/worker_pool.h"
+
+namespace s21 {
+
+/// @brief Упорядоченное хранилище на B+дереве. Внутренние узлы широкие и
+/// выровнены по строке кэша. Узел помнит общий префикс своих ключей и
+/// массив 4-байтовых кусков ключей сразу за ним, так что при спуске почти
+/// все сравнения - сравнения целых чисел внутри одного-двух кэш-блоков.
+/// Записи лежат прямо в листьях, листья связаны в двусвязный список для
+/// последовательного обхода.
+class BPlusTree : public OrderedKeyValue {
+ public:
+  BPlusTree();
+  ~BPlusTree() override;
+  BPlusTree(const BPlusTree &) = delete;
+  auto operator=(const BPlusTree &) -> BPlusTree & = delete;
+
+  /// @brief Команда используется для установки ключа и его значения.
+  /// @param key
+  /// @param last_name
+  /// @param first_name
+  /// @param year_of_birth
+  /// @param city
+  /// @param number_of_current_coins
+  /// @param time_of_life
+  auto Set(Peer peer, int time_of_life = 0) -> void override;
+
+  /// @brief Команда используется для получения значения, связанного с ключом.
+  /// Указатель действителен до следующей изменяющей операции.
+  /// @param key
+  /// @return Если такой записи нет, то будет возвращён (null):
+  auto Get(const std::string &key) -> Peer * override;
+
+  /// @brief Эта команда проверяет, существует ли запись с данным ключом.
+  /// @param key
+  /// @return Возвращает true если объект существует или false если нет:
+  auto Exists(const std::string &key) -> bool override;
+
+  /// @brief Команда удаляет ключ и соответствующее значение.
+  /// @param key
+  /// @return Возвращает true, если запись успешно удалена, в противном случае -
+  /// false
+  auto Del(const std::string &key) -> bool override;
+
+  /// @brief Команда обновляет значение по соответствующему ключу, если такой
+  /// ключ существует
+  /// @param key
+  /// @param last_name
+  /// @param first_name
+  /// @param year_of_birth
+  /// @param city
+  /// @param number_of_current_coins
+  auto Update(const std::string &key, const std::string &last_name = "",
+              const std::string &first_name = "", int year_of_birth = 0,
+              const std::string &city = "", int number_of_current_coins = 0)
+      -> void override;
+
+  /// @brief Возвращает все ключи, которые есть в хранилище:
+  /// @return
+  auto Keys() -> std::vector<std::string> override;
+  using OrderedKeyValue::Keys;
+
+  /// @brief Команда используется для переименования ключей
+  /// @param key_old
+  /// @param key_new
+  /// @return
+  auto Rename(const std::string &key_old, const std::string &key_new)
+      -> void override;
+
+  /// @brief Когда ключ установлен с истечением срока действия, эту команду
+  /// можно использовать для просмотра оставшегося времени.
+  /// @param key
+  /// @return Если записи с заданным ключом не существует, то возвращается 0
+  auto TTL(const std::string &key) -> int override;
+
+  /// @brief Устанавливает время жизни существующего ключа, не меняя значения.
+  /// @param key
+  /// @param seconds если не больше 0, ключ удаляется сразу
+  /// @return Возвращает false, если ключа нет
+  auto Expire(const std::string &key, int seconds) -> bool override;
+
+  /// @brief Снимает ограничение времени жизни ключа.
+  /// @param key
+  /// @return Возвращает true, если у ключа было время жизни
+  auto Persist(const std::string &key) -> bool override;
+
+  /// @brief Оставшееся время жизни ключа в миллисекундах.
+  /// @param key
+  /// @return -2, если ключа нет, и -1, если время жизни не ограничено
+  auto PTTL(const std::string &key) -> int64_t override;
+
+  /// @brief Срок истечения ключа в миллисекундах по часам Expirer::NowMs.
+  /// @param key
+  /// @return -2, если ключа нет, и -1, если время жизни не ограничено
+  auto PExpireTime(const std::string &key) -> int64_t override;
+
+  /// @brief Устанавливает абсолютный срок истечения существующего ключа.
+  /// @param key
+  /// @param deadline 0 - без ограничения; наступивший срок удаляет ключ
+  /// @return Возвращает false, если ключа нет
+  auto PExpireAt(const std::string &key, int64_t deadline) -> bool override;
+
+  /// @brief Эта команда используется для восстановления ключа (или ключей) по
+  /// заданному значению.
+  /// @param last_name
+  /// @param first_name
+  /// @param year_of_birth
+  /// @param city
+  /// @param number_of_current_coins
+  /// @return
+  auto Find(const std::string &last_name = "",
+            const std::string &first_name = "", int year_of_birth = 0,
+            const std::string &city = "", int number_of_current_coins = -1)
+      -> std::vector<std::string> override;
+
+  /// @brief Включает или выключает вторичные индексы по полям значения,
+  /// ускоряющие Find. При включении индексы строятся по текущим данным.
+  /// @param enable
+  /// @return true
+  auto SetIndexing(bool enable) -> bool override;
+
+  /// @brief Включает или выключает колоночную копию полей значения, по
+  /// которой Find без индексов выполняется векторным сканированием.
+  /// @param enable
+  /// @return true
+  auto SetColumnar(bool enable) -> bool override;
+
+  /// @brief Полный обход делится на отрезки списка листьев, которые
+  /// склеиваются в порядке ключей.
+  /// @param parts
+  /// @return true
+  auto SetParallelScan(size_t parts) -> bool override;
+
+  /// @brief Команда для получения всех записей, которые содержатся в key-value
+  /// хранилище на текущий момент
+  /// @return
+  auto ShowAll() -> std::vector<Peer *> override;
+
+  /// @brief Обходит записи с ключами из [from, to) в порядке ключей по
+  /// связанному списку листьев.
+  /// @param from пустая строка - от наименьшего ключа
+  /// @param to пустая строка - до наибольшего ключа включительно
+  /// @param visit
+  /// @param reverse обход по убыванию ключей
+  auto ScanRange(const std::string &from, const std::string &to,
+                 const Visitor &visit, bool reverse = false) -> void override;
+
+  /// @brief Цикл активного удаления истёкших ключей. Хранилище запускает его
+  /// само по ходу операций, но его можно вызывать и в периоды простоя.
+  /// @param budget ограничение времени работы цикла
+  /// @return Число удалённых записей
+  auto ActiveExpireCycle(
+      std::chrono::microseconds budget = std::chrono::milliseconds(1))
+      -> size_t override;
+
+  /// @brief Данная команда используется для загрузки данных из файла.
+  /// @param data_directory
+  /// @return Выводится число загруженных строк из файла.
+  auto Upload(const std::string &data_directory) -> int override;
+
+  /// @brief Данная команда используется для выгрузки данных, которые находятся
+  /// в текущий момент в key-value хранилище в файл.
+  /// @param data_directory
+  /// @return Число выгруженных строк из файла.
+  auto ExportData(const std::string &data_directory) -> int override;
+
+  /// @brief Число уровней дерева; 1, если корень - лист.
+  auto Height() const -> int { return height_; }
+
+  /// Ключей во внутреннем узле и записей в листе.
+  static constexpr int kSlots = 32;
+
+ private:
+  static constexpr int kMinSlots = kSlots / 2;
+  static constexpr int kMaxDepth = 24;
+  /// Меньше записей на часть обход не делит: запуск части дороже.
+  static constexpr size_t kMinScanPart = 1 << 14;
+
+  struct Record {
+    Peer peer;
+    int64_t deadline = 0;
+  };
+
+  struct alignas(64) Node {
+    explicit Node(bool is_leaf) : leaf(is_leaf) {}
+    /// Длина общего префикса всех ключей узла и по 4 байта каждого ключа
+    /// сразу после него.
+    uint32_t skip = 0;
+    std::array<uint32_t, kSlots> prefix{};
+    int count = 0;
+    bool leaf;
+  };
+
+  /// Ключ keys[i] - наименьший ключ поддерева children[i + 1].
+  struct Inner : Node {
+    Inner() : Node(false) {}
+    std::array<CompactKey, kSlots> keys;
+    std::array<Node *, kSlots + 1> children{};
+  };
+
+  struct Leaf : Node {
+    Leaf() : Node(true) {}
+    Leaf *prev = nullptr;
+    Leaf *next = nullptr;
+    std::array<Record, kSlots> records;
+  };
+
+  /// Путь спуска: узел и номер потомка, в который пошёл спуск.
+  struct Path {
+    std::array<std::pair<Inner *, int>, kMaxDepth> steps;
+    int depth = 0;
+  };
+
+  struct Position {
+    Leaf *leaf;
+    int index;
+
+    explicit operator bool() const { return leaf != nullptr; }
+    auto record() const -> Record & { return leaf->records[index]; }
+  };
+
+  static auto Prefix(std::string_view key) -> uint32_t;
+  static auto Compare(uint32_t prefix, std::string_view key,
+                      uint32_t node_prefix, const CompactKey &node_key)
+      -> int;
+  static auto KeyAt(const Node *node, int i) -> std::string_view;
+  static auto Refresh(Node *node) -> void;
+  static auto Probe(const Node *node, std::string_view key, uint32_t *prefix)
+      -> int;
+  static auto UpperBound(const Inner *inner, std::string_view key) -> int;
+  static auto LowerBound(const Leaf *leaf, std::string_view key) -> int;
+  static auto InsertKey(Inner *inner, int i, CompactKey &&key, Node *right)
+      -> void;
+  static auto RemoveKey(Inner *inner, int i) -> void;
+
+  auto Descend(std::string_view key, Path *path) const -> Leaf *;
+  auto Seek(std::string_view key) const -> Position;
+  auto SeekBefore(std::string_view key) const -> Position;
+  auto Locate(std::string_view key) const -> Position;
+  auto LocateLive(std::string_view key) -> Position;
+  auto Insert(Peer &&peer, bool *inserted) -> Position;
+  auto InsertIntoParent(Path *path, Node *left, CompactKey &&separator,
+                        Node *right) -> void;
+  auto Unlink(std::string_view key, Record *removed = nullptr) -> void;
+  auto RemoveAt(Path *path, Leaf *leaf, int i, Record *removed) -> void;
+  auto RebalanceLeaf(Inner *parent, int i) -> void;
+  auto RebalanceInner(Inner *parent, int i) -> void;
+
+  auto EraseAt(const Position &pos) -> void;
+  auto SetDeadline(const Position &pos, int64_t deadline) -> void;
+  auto Track(const Peer &peer) -> void;
+  auto Untrack(const Peer &peer) -> void;
+  auto Reclaim(const std::string &key, int64_t deadline) -> bool;
+  auto Tick() -> void;
+  template <typename Func>
+  auto ForEach(Func func) -> void;
+  template <typename T, typename Func>
+  auto Collect(Func func) -> std::vector<T>;
+
+  NodePool<Leaf> leaves_;
+  NodePool<Inner> inners_;
+  Node *root_;
+  Leaf *first_leaf_;
+  Leaf *last_leaf_;
+  size_t size_ = 0;
+  int height_ = 1;
+
+  Expirer expiry_;
+  SecondaryIndex index_;
+  ColumnStore columns_;
+  bool indexing_ = false;
+  bool columnar_ = false;
+  size_t scan_parts_ = WorkerCount();
+};
+
+}  // namespace s21
+
+#endif  // A6_B_PLUS_TREE_H
@@ -0,0 +1,398 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "b_plus_tree.h"
+
+namespace s21 {
+
+// Первые 4 байта ключа как число big-endian: порядок префиксов совпадает с
+// лексикографическим порядком ключей, равные префиксы решает полное
+// сравнение.
+auto BPlusTree::Prefix(std::string_view key) -> uint32_t {
+  uint32_t prefix = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    prefix <<= 8;
+    if (i < key.size()) prefix |= static_cast<unsigned char>(key[i]);
+  }
+  return prefix;
+}
+
+auto BPlusTree::Compare(uint32_t prefix, std::string_view key,
+                        uint32_t node_prefix, const CompactKey &node_key)
+    -> int {
+  if (prefix != node_prefix) return prefix < node_prefix ? -1 : 1;
+  return -node_key.Compare(key);
+}
+
+// Номер первого ключа, большего key, то есть номер потомка для спуска.
+auto BPlusTree::UpperBound(const Inner *inner, std::string_view key) -> int {
+  uint32_t prefix = 0;
+  int side = Probe(inner, key, &prefix);
+  if (side) return side < 0 ? 0 : inner->count;
+  int lo = 0;
+  int hi = inner->count;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (Compare(prefix, key, inner->prefix[mid], inner->keys[mid]) < 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+
+// Номер первой записи с ключом не меньше key.
+auto BPlusTree::LowerBound(const Leaf *leaf, std::string_view key) -> int {
+  uint32_t prefix = 0;
+  int side = Probe(leaf, key, &prefix);
+  if (side) return side < 0 ? 0 : leaf->count;
+  int lo = 0;
+  int hi = leaf->count;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (Compare(prefix, key, leaf->prefix[mid],
+                leaf->records[mid].peer.key) > 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+auto BPlusTree::KeyAt(const Node *node, int i) -> std::string_view {
+  if (node->leaf)
+    return static_cast<const Leaf *>(node)->records[i].peer.key.View();
+  return static_cast<const Inner *>(node)->keys[i].View();
+}
+
+// Пересчитывает общий префикс ключей узла и 4-байтовые префиксы после него.
+// Ключи узла упорядочены, поэтому общий префикс всех ключей равен общему
+// префиксу первого и последнего.
+auto BPlusTree::Refresh(Node *node) -> void {
+  node->skip = 0;
+  if (node->count == 0) return;
+  std::string_view first = KeyAt(node, 0);
+  std::string_view last = KeyAt(node, node->count - 1);
+  size_t n = std::min(first.size(), last.size());
+  size_t skip = 0;
+  while (skip < n && first[skip] == last[skip]) ++skip;
+  node->skip = static_cast<uint32_t>(skip);
+  for (int i = 0; i < node->count; ++i)
+    node->prefix[i] = Prefix(KeyAt(node, i).substr(skip));
+}
+
+// Сравнивает key с общим префиксом ключей узла. Возвращает -1 или 1, если
+// key меньше или больше всех ключей узла; иначе 0 и префикс key после
+// общей части.
+auto BPlusTree::Probe(const Node *node, std::string_view key, uint32_t *prefix)
+    -> int {
+  size_t skip = node->skip;
+  if (skip) {
+    std::string_view common = KeyAt(node, 0).substr(0, skip);
+    int cmp = key.compare(0, skip, common);
+    if (cmp) return cmp < 0 ? -1 : 1;
+  }
+  *prefix = Prefix(key.substr(skip));
+  return 0;
+}
+
+// Вставляет ключ на место i и правого потомка на место i + 1.
+auto BPlusTree::InsertKey(Inner *inner, int i, CompactKey &&key, Node *right)
+    -> void {
+  for (int j = inner->count; j > i; --j) {
+    inner->keys[j] = std::move(inner->keys[j - 1]);
+    inner->children[j + 1] = inner->children[j];
+  }
+  inner->keys[i] = std::move(key);
+  inner->children[i + 1] = right;
+  ++inner->count;
+  Refresh(inner);
+}
+
+// Удаляет ключ i вместе с правым от него потомком.
+auto BPlusTree::RemoveKey(Inner *inner, int i) -> void {
+  for (int j = i; j + 1 < inner->count; ++j) {
+    inner->keys[j] = std::move(inner->keys[j + 1]);
+    inner->children[j + 1] = inner->children[j + 2];
+  }
+  --inner->count;
+  inner->children[inner->count + 1] = nullptr;
+  Refresh(inner);
+}
+
+auto BPlusTree::Descend(std::string_view key, Path *path) const -> Leaf * {
+  Node *node = root_;
+  while (!node->leaf) {
+    auto *inner = static_cast<Inner *>(node);
+    int i = UpperBound(inner, key);
+    if (path) path->steps[path->depth++] = {inner, i};
+    node = inner->children[i];
+  }
+  return static_cast<Leaf *>(node);
+}
+
+// Первая запись с ключом не меньше key.
+auto BPlusTree::Seek(std::string_view key) const -> Position {
+  Leaf *leaf = Descend(key, nullptr);
+  int i = LowerBound(leaf, key);
+  while (leaf && i == leaf->count) {
+    leaf = leaf->next;
+    i = 0;
+  }
+  return {leaf, i};
+}
+
+// Последняя запись с ключом меньше key; для пустого key - последняя запись.
+auto BPlusTree::SeekBefore(std::string_view key) const -> Position {
+  Leaf *leaf = last_leaf_;
+  int i = leaf->count;
+  if (!key.empty()) {
+    leaf = Descend(key, nullptr);
+    i = LowerBound(leaf, key);
+  }
+  while (leaf && i == 0) {
+    leaf = leaf->prev;
+    i = leaf ? leaf->count : 0;
+  }
+  return {leaf, i - 1};
+}
+
+auto BPlusTree::Locate(std::string_view key) const -> Position {
+  Leaf *leaf = Descend(key, nullptr);
+  int i = LowerBound(leaf, key);
+  if (i < leaf->count && leaf->records[i].peer.key.Equals(key))
+    return {leaf, i};
+  return {nullptr, 0};
+}
+
+// Один спуск: находит существующую запись или вставляет новую, при
+// необходимости деля переполненные узлы снизу вверх.
+auto BPlusTree::Insert(Peer &&peer, bool *inserted) -> Position {
+  std::string_view key = peer.key.View();
+  Path path;
+  Leaf *leaf = Descend(key, &path);
+  int i = LowerBound(leaf, key);
+  if (i < leaf->count && leaf->records[i].peer.key.Equals(key)) {
+    *inserted = false;
+    return {leaf, i};
+  }
+  *inserted = true;
+  if (leaf->count == kSlots) {
+    auto *right = leaves_.New();
+    for (int j = kMinSlots; j < kSlots; ++j) {
+      right->records[j - kMinSlots] = std::move(leaf->records[j]);
+    }
+    right->count = kSlots - kMinSlots;
+    leaf->count = kMinSlots;
+    right->next = leaf->next;
+    right->prev = leaf;
+    if (right->next) right->next->prev = right;
+    leaf->next = right;
+    if (last_leaf_ == leaf) last_leaf_ = right;
+    Refresh(leaf);
+    Refresh(right);
+    InsertIntoParent(&path, leaf, CompactKey(right->records[0].peer.key),
+                     right);
+    if (i > kMinSlots) {
+      leaf = right;
+      i -= kMinSlots;
+    }
+  }
+  for (int j = leaf->count; j > i; --j) {
+    leaf->records[j] = std::move(leaf->records[j - 1]);
+  }
+  leaf->records[i] = Record{std::move(peer), 0};
+  ++leaf->count;
+  Refresh(leaf);
+  ++size_;
+  return {leaf, i};
+}
+
+auto BPlusTree::InsertIntoParent(Path *path, Node *left,
+                                 CompactKey &&separator, Node *right)
+    -> void {
+  while (path->depth > 0) {
+    auto [parent, i] = path->steps[--path->depth];
+    if (parent->count < kSlots) {
+      InsertKey(parent, i, std::move(separator), right);
+      return;
+    }
+    // Узел полон: раскладываем kSlots + 1 ключей на две половины, средний
+    // ключ уходит уровнем выше.
+    std::array<CompactKey, kSlots + 1> keys;
+    std::array<Node *, kSlots + 2> children;
+    for (int j = 0, k = 0; j <= kSlots; ++j) {
+      if (j == i) {
+        keys[j] = std::move(separator);
+      } else {
+        keys[j] = std::move(parent->keys[k++]);
+      }
+    }
+    for (int j = 0, k = 0; j <= kSlots + 1; ++j) {
+      children[j] = j == i + 1 ? right : parent->children[k++];
+    }
+    constexpr int mid = (kSlots + 1) / 2;
+    auto *sibling = inners_.New();
+    parent->count = 0;
+    for (int j = 0; j < mid; ++j) parent->keys[j] = std::move(keys[j]);
+    for (int j = 0; j <= mid; ++j) parent->children[j] = children[j];
+    for (int j = mid + 1; j <= kSlots + 1; ++j) parent->children[j] = nullptr;
+    parent->count = mid;
+    for (int j = mid + 1; j <= kSlots; ++j)
+      sibling->keys[j - mid - 1] = std::move(keys[j]);
+    for (int j = mid + 1; j <= kSlots + 1; ++j)
+      sibling->children[j - mid - 1] = children[j];
+    sibling->count = kSlots - mid;
+    Refresh(parent);
+    Refresh(sibling);
+    left = parent;
+    separator = std::move(keys[mid]);
+    right = sibling;
+  }
+  if (height_ >= kMaxDepth) throw std::length_error("BPlusTree: too deep");
+  auto *root = inners_.New();
+  root->children[0] = left;
+  InsertKey(root, 0, std::move(separator), right);
+  root_ = root;
+  ++height_;
+}
+
+// Удаляет запись, при необходимости отдавая её в removed. Недозаполненные
+// узлы занимают запись у соседа или сливаются с ним, так что все узлы,
+// кроме корня, заполнены хотя бы наполовину.
+auto BPlusTree::Unlink(std::string_view key, Record *removed) -> void {
+  Path path;
+  Leaf *leaf = Descend(key, &path);
+  int i = LowerBound(leaf, key);
+  if (i == leaf->count || !leaf->records[i].peer.key.Equals(key)) return;
+  RemoveAt(&path, leaf, i, removed);
+}
+
+// Удаляет запись i листа, до которого спуск прошёл по path.
+auto BPlusTree::RemoveAt(Path *path, Leaf *leaf, int i, Record *removed)
+    -> void {
+  if (removed) *removed = std::move(leaf->records[i]);
+  for (int j = i; j + 1 < leaf->count; ++j) {
+    leaf->records[j] = std::move(leaf->records[j + 1]);
+  }
+  leaf->records[--leaf->count] = Record{};
+  Refresh(leaf);
+  --size_;
+  Node *node = leaf;
+  while (path->depth > 0 && node->count < kMinSlots) {
+    auto [parent, child] = path->steps[--path->depth];
+    if (node->leaf) {
+      RebalanceLeaf(parent, child);
+    } else {
+      RebalanceInner(parent, child);
+    }
+    node = parent;
+  }
+  if (!root_->leaf && root_->count == 0) {
+    auto *old = static_cast<Inner *>(root_);
+    root_ = old->children[0];
+    inners_.Delete(old);
+    --height_;
+  }
+}
+
+auto BPlusTree::RebalanceLeaf(Inner *parent, int i) -> void {
+  auto *leaf = static_cast<Leaf *>(parent->children[i]);
+  auto *left = i > 0 ? static_cast<Leaf *>(parent->children[i - 1]) : nullptr;
+  auto *right = i < parent->count
+                    ? static_cast<Leaf *>(parent->children[i + 1])
+                    : nullptr;
+  if (left && left->count > kMinSlots) {
+    for (int j = leaf->count; j > 0; --j) {
+      leaf->records[j] = std::move(leaf->records[j - 1]);
+    }
+    leaf->records[0] = std::move(left->records[--left->count]);
+    ++leaf->count;
+    parent->keys[i - 1] = CompactKey(leaf->records[0].peer.key);
+    Refresh(leaf);
+    Refresh(left);
+    Refresh(parent);
+    return;
+  }
+  if (right && right->count > kMinSlots) {
+    leaf->records[leaf->count++] = std::move(right->records[0]);
+    for (int j = 0; j + 1 < right->count; ++j) {
+      right->records[j] = std::move(right->records[j + 1]);
+    }
+    --right->count;
+    parent->keys[i] = CompactKey(right->records[0].peer.key);
+    Refresh(leaf);
+    Refresh(right);
+    Refresh(parent);
+    return;
+  }
+  if (!left) {
+    left = leaf;
+  } else {
+    right = leaf;
+    --i;
+  }
+  for (int j = 0; j < right->count; ++j) {
+    left->records[left->count + j] = std::move(right->records[j]);
+  }
+  left->count += right->count;
+  Refresh(left);
+  left->next = right->next;
+  if (left->next) left->next->prev = left;
+  if (last_leaf_ == right) last_leaf_ = left;
+  RemoveKey(parent, i);
+  leaves_.Delete(right);
+}
+
+auto BPlusTree::RebalanceInner(Inner *parent, int i) -> void {
+  auto *node = static_cast<Inner *>(parent->children[i]);
+  auto *left = i > 0 ? static_cast<Inner *>(parent->children[i - 1]) : nullptr;
+  auto *right = i < parent->count
+                    ? static_cast<Inner *>(parent->children[i + 1])
+                    : nullptr;
+  if (left && left->count > kMinSlots) {
+    node->children[node->count + 1] = node->children[node->count];
+    for (int j = node->count; j > 0; --j) {
+      node->keys[j] = std::move(node->keys[j - 1]);
+      node->children[j] = node->children[j - 1];
+    }
+    node->keys[0] = std::move(parent->keys[i - 1]);
+    node->children[0] = left->children[left->count];
+    ++node->count;
+    parent->keys[i - 1] = std::move(left->keys[left->count - 1]);
+    left->children[left->count--] = nullptr;
+    Refresh(node);
+    Refresh(left);
+    Refresh(parent);
+    return;
+  }
+  if (right && right->count > kMinSlots) {
+    node->keys[node->count] = std::move(parent->keys[i]);
+    node->children[++node->count] = right->children[0];
+    parent->keys[i] = std::move(right->keys[0]);
+    right->children[0] = right->children[1];
+    RemoveKey(right, 0);
+    Refresh(node);
+    Refresh(parent);
+    return;
+  }
+  if (!left) {
+    left = node;
+  } else {
+    right = node;
+    --i;
+  }
+  left->keys[left->count] = std::move(parent->keys[i]);
+  for (int j = 0; j < right->count; ++j)
+    left->keys[left->count + 1 + j] = std::move(right->keys[j]);
+  for (int j = 0; j <= right->count; ++j)
+    left->children[left->count + 1 + j] = right->children[j];
+  left->count += 1 + right->count;
+  Refresh(left);
+  RemoveKey(parent, i);
+  inners_.Delete(right);
+}
+
+}  // namespace s21
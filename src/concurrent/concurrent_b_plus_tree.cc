@@ -0,0 +1,699 @@
+#include "concurrent_b_plus_tree.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "../expiration/expirer.h"
+#include "../index/peer_filter.h"
+#include "../other/record_loader.h"
+#include "../other/worker_pool.h"
+
+namespace s21 {
+
+ConcurrentBPlusTree::ConcurrentBPlusTree() : root_(new Leaf) {}
+
+// Разрушение допускается только после завершения всех потоков, которые
+// обращаются к дереву.
+ConcurrentBPlusTree::~ConcurrentBPlusTree() { Destroy(root_.load()); }
+
+auto ConcurrentBPlusTree::Destroy(Node *node) -> void {
+  if (node->leaf) {
+    auto *leaf = static_cast<Leaf *>(node);
+    for (size_t i = 0; i < leaf->count.load(); ++i)
+      delete leaf->records[i].load();
+    delete leaf;
+    return;
+  }
+  auto *inner = static_cast<Inner *>(node);
+  size_t count = inner->count.load();
+  for (size_t i = 0; i < count; ++i) delete inner->keys[i].load();
+  for (size_t i = 0; i <= count; ++i) Destroy(inner->children[i].load());
+  delete inner;
+}
+
+// Ждёт, пока узел не будет разблокирован, и возвращает его версию.
+auto ConcurrentBPlusTree::ReadLock(const Node *node) -> uint64_t {
+  uint64_t version = node->version.load(std::memory_order_acquire);
+  while (version & 1) {
+    std::this_thread::yield();
+    version = node->version.load(std::memory_order_acquire);
+  }
+  return version;
+}
+
+auto ConcurrentBPlusTree::Validate(const Node *node, uint64_t version)
+    -> bool {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return node->version.load(std::memory_order_relaxed) == version;
+}
+
+// Блокирует узел, только если он не менялся с момента чтения версии.
+auto ConcurrentBPlusTree::Upgrade(Node *node, uint64_t version) -> bool {
+  if (!node->version.compare_exchange_strong(version, version + 1,
+                                             std::memory_order_acquire))
+    return false;
+  std::atomic_thread_fence(std::memory_order_release);
+  return true;
+}
+
+auto ConcurrentBPlusTree::Unlock(Node *node) -> void {
+  node->version.fetch_add(1, std::memory_order_release);
+}
+
+// Индекс поддерева для key: число разделителей, не больших key (при strict -
+// меньших). false, если узел читается в момент изменения.
+auto ConcurrentBPlusTree::Route(const Inner *inner, size_t count,
+                                std::string_view key, bool strict,
+                                size_t *index) -> bool {
+  size_t low = 0, high = count;
+  while (low < high) {
+    size_t middle = (low + high) / 2;
+    const std::string *separator =
+        inner->keys[middle].load(std::memory_order_acquire);
+    if (!separator) return false;
+    int order = separator->compare(key);
+    if (order < 0 || (!strict && order == 0)) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  *index = low;
+  return true;
+}
+
+// Вызывается под блокировкой листа.
+auto ConcurrentBPlusTree::Position(const Leaf *leaf, std::string_view key,
+                                   bool *found) -> size_t {
+  size_t low = 0, high = leaf->count.load(std::memory_order_relaxed);
+  while (low < high) {
+    size_t middle = (low + high) / 2;
+    if (leaf->records[middle].load(std::memory_order_relaxed)->peer.key.Compare(
+            key) < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  *found = low < leaf->count.load(std::memory_order_relaxed) &&
+           leaf->records[low].load(std::memory_order_relaxed)->peer.key.Equals(
+               key);
+  return low;
+}
+
+auto ConcurrentBPlusTree::Retire(Record *record) -> void {
+  EpochManager::Instance().Retire(
+      record, [](void *object) { delete static_cast<Record *>(object); });
+}
+
+// Оптимистичный спуск к листу: версия каждого узла сверяется после чтения
+// ссылки на потомка. false - дерево менялось, спуск надо повторить.
+// Вызывающий должен находиться в эпохе.
+auto ConcurrentBPlusTree::ReadLeaf(std::string_view key, Seek seek,
+                                   Snapshot *out) const -> bool {
+  out->count = 0;
+  out->low = out->high = nullptr;
+  const Node *node = root_.load(std::memory_order_acquire);
+  uint64_t version = ReadLock(node);
+  if (node != root_.load(std::memory_order_acquire)) return false;
+  while (!node->leaf) {
+    auto *inner = static_cast<const Inner *>(node);
+    size_t count = std::min(inner->count.load(std::memory_order_relaxed),
+                            kInnerKeys);
+    size_t index = count;
+    if (seek != Seek::kLast &&
+        !Route(inner, count, key, seek == Seek::kBefore, &index))
+      return false;
+    if (index > 0) out->low = inner->keys[index - 1].load();
+    if (index < count) out->high = inner->keys[index].load();
+    const Node *child = inner->children[index].load(std::memory_order_acquire);
+    if (!child) return false;
+    uint64_t child_version = ReadLock(child);
+    if (!Validate(inner, version)) return false;
+    node = child;
+    version = child_version;
+  }
+  auto *leaf = static_cast<const Leaf *>(node);
+  size_t count =
+      std::min(leaf->count.load(std::memory_order_relaxed), kLeafSlots);
+  for (size_t i = 0; i < count; ++i) {
+    const Record *record = leaf->records[i].load(std::memory_order_acquire);
+    if (!record) return false;
+    out->records[out->count++] = record;
+  }
+  return Validate(leaf, version);
+}
+
+auto ConcurrentBPlusTree::Lookup(std::string_view key) const
+    -> const Record * {
+  Snapshot snapshot;
+  while (!ReadLeaf(key, Seek::kAtOrAfter, &snapshot)) {
+  }
+  auto end = snapshot.records.begin() + snapshot.count;
+  auto it = std::lower_bound(snapshot.records.begin(), end, key,
+                             [](const Record *record, std::string_view value) {
+                               return record->peer.key.Compare(value) < 0;
+                             });
+  if (it == end || !(*it)->peer.key.Equals(key)) return nullptr;
+  if (Expirer::Expired((*it)->deadline, Expirer::NowMs())) return nullptr;
+  return *it;
+}
+
+// Спуск идёт в эпохе: опустевшие листья освобождаются через EpochManager.
+// Заблокированный лист исключить нельзя, поэтому он остаётся верным и
+// после выхода из эпохи.
+auto ConcurrentBPlusTree::LockLeaf(std::string_view key, bool need_room)
+    -> Leaf * {
+  EpochGuard guard;
+  while (true) {
+    if (Leaf *leaf = TryLockLeaf(key, need_room)) return leaf;
+  }
+}
+
+// Спуск к листу ключа с блокировкой только самого листа. Полный внутренний
+// узел по дороге, а при need_room и полный лист, расщепляется, после чего
+// спуск повторяется; родитель к этому моменту заведомо не полон.
+auto ConcurrentBPlusTree::TryLockLeaf(std::string_view key, bool need_room)
+    -> Leaf * {
+  Node *node = root_.load(std::memory_order_acquire);
+  uint64_t version = ReadLock(node);
+  if (node != root_.load(std::memory_order_acquire)) return nullptr;
+  Inner *parent = nullptr;
+  uint64_t parent_version = 0;
+  while (true) {
+    size_t count = node->count.load(std::memory_order_relaxed);
+    bool full = node->leaf ? need_room && count >= kLeafSlots
+                           : count >= kInnerKeys;
+    if (full) {
+      Split(parent, parent_version, node, version);
+      return nullptr;
+    }
+    if (node->leaf) {
+      if (!Upgrade(node, version)) return nullptr;
+      if (parent && !Validate(parent, parent_version)) {
+        Unlock(node);
+        return nullptr;
+      }
+      return static_cast<Leaf *>(node);
+    }
+    auto *inner = static_cast<Inner *>(node);
+    size_t index = 0;
+    if (!Route(inner, count, key, false, &index)) return nullptr;
+    Node *child = inner->children[index].load(std::memory_order_acquire);
+    if (!child || !Validate(inner, version)) return nullptr;
+    if (parent && !Validate(parent, parent_version)) return nullptr;
+    parent = inner;
+    parent_version = version;
+    node = child;
+    version = ReadLock(child);
+    if (!Validate(inner, parent_version)) return nullptr;
+  }
+}
+
+// Делит узел пополам под блокировкой его и родителя. Новый правый узел
+// заполняется до публикации, поэтому читатели видят его только целым.
+auto ConcurrentBPlusTree::Split(Inner *parent, uint64_t parent_version,
+                                Node *node, uint64_t version) -> void {
+  if (parent && !Upgrade(parent, parent_version)) return;
+  if (!Upgrade(node, version)) {
+    if (parent) Unlock(parent);
+    return;
+  }
+  if (!parent && node != root_.load(std::memory_order_relaxed)) {
+    Unlock(node);
+    return;
+  }
+  const std::string *separator = nullptr;
+  Node *right = nullptr;
+  if (node->leaf) {
+    auto *leaf = static_cast<Leaf *>(node);
+    auto *half = new Leaf;
+    size_t middle = kLeafSlots / 2;
+    for (size_t i = middle; i < kLeafSlots; ++i) {
+      half->records[i - middle].store(leaf->records[i].load(),
+                                      std::memory_order_relaxed);
+      leaf->records[i].store(nullptr, std::memory_order_relaxed);
+    }
+    half->count.store(kLeafSlots - middle, std::memory_order_relaxed);
+    leaf->count.store(middle, std::memory_order_relaxed);
+    separator = new std::string(half->records[0].load()->peer.key);
+    right = half;
+  } else {
+    auto *inner = static_cast<Inner *>(node);
+    auto *half = new Inner;
+    size_t middle = kInnerKeys / 2;
+    separator = inner->keys[middle].load();
+    for (size_t i = middle + 1; i < kInnerKeys; ++i) {
+      half->keys[i - middle - 1].store(inner->keys[i].load(),
+                                       std::memory_order_relaxed);
+    }
+    for (size_t i = middle + 1; i <= kInnerKeys; ++i) {
+      half->children[i - middle - 1].store(inner->children[i].load(),
+                                           std::memory_order_relaxed);
+      inner->children[i].store(nullptr, std::memory_order_relaxed);
+    }
+    for (size_t i = middle; i < kInnerKeys; ++i)
+      inner->keys[i].store(nullptr, std::memory_order_relaxed);
+    half->count.store(kInnerKeys - middle - 1, std::memory_order_relaxed);
+    inner->count.store(middle, std::memory_order_relaxed);
+    right = half;
+  }
+  if (parent) {
+    size_t count = parent->count.load(std::memory_order_relaxed);
+    size_t index = 0;
+    Route(parent, count, *separator, false, &index);
+    for (size_t i = count; i > index; --i) {
+      parent->keys[i].store(parent->keys[i - 1].load(),
+                            std::memory_order_release);
+      parent->children[i + 1].store(parent->children[i].load(),
+                                    std::memory_order_release);
+    }
+    parent->keys[index].store(separator, std::memory_order_release);
+    parent->children[index + 1].store(right, std::memory_order_release);
+    parent->count.store(count + 1, std::memory_order_release);
+  } else {
+    auto *root = new Inner;
+    root->keys[0].store(separator, std::memory_order_relaxed);
+    root->children[0].store(node, std::memory_order_relaxed);
+    root->children[1].store(right, std::memory_order_relaxed);
+    root->count.store(1, std::memory_order_relaxed);
+    root_.store(root, std::memory_order_release);
+  }
+  Unlock(node);
+  if (parent) Unlock(parent);
+}
+
+// При overwrite живая запись с тем же ключом заменяется, иначе остаётся.
+auto ConcurrentBPlusTree::InsertRecord(Record *record, bool overwrite)
+    -> void {
+  std::string_view key = record->peer.key.View();
+  Leaf *leaf = LockLeaf(key, true);
+  bool found = false;
+  size_t index = Position(leaf, key, &found);
+  if (found) {
+    Record *old = leaf->records[index].load(std::memory_order_relaxed);
+    if (!overwrite && !Expirer::Expired(old->deadline, Expirer::NowMs())) {
+      Unlock(leaf);
+      delete record;
+      return;
+    }
+    leaf->records[index].store(record, std::memory_order_release);
+    Unlock(leaf);
+    Retire(old);
+    return;
+  }
+  size_t count = leaf->count.load(std::memory_order_relaxed);
+  for (size_t i = count; i > index; --i) {
+    leaf->records[i].store(leaf->records[i - 1].load(),
+                           std::memory_order_release);
+  }
+  leaf->records[index].store(record, std::memory_order_release);
+  leaf->count.store(count + 1, std::memory_order_release);
+  Unlock(leaf);
+  size_.fetch_add(1);
+}
+
+// Заменяет живую запись на make(запись) или удаляет её, если make вернул
+// nullptr. false, если живой записи нет.
+template <typename Make>
+auto ConcurrentBPlusTree::ModifyLive(std::string_view key, Make make) -> bool {
+  Leaf *leaf = LockLeaf(key, false);
+  bool found = false;
+  size_t index = Position(leaf, key, &found);
+  Record *old =
+      found ? leaf->records[index].load(std::memory_order_relaxed) : nullptr;
+  if (!old || Expirer::Expired(old->deadline, Expirer::NowMs())) {
+    Unlock(leaf);
+    return false;
+  }
+  if (Record *record = make(*old)) {
+    leaf->records[index].store(record, std::memory_order_release);
+  } else {
+    size_t count = leaf->count.load(std::memory_order_relaxed);
+    for (size_t i = index + 1; i < count; ++i) {
+      leaf->records[i - 1].store(leaf->records[i].load(),
+                                 std::memory_order_release);
+    }
+    leaf->records[count - 1].store(nullptr, std::memory_order_release);
+    leaf->count.store(count - 1, std::memory_order_release);
+    size_.fetch_sub(1);
+    if (count == 1) {
+      Unlock(leaf);
+      Retire(old);
+      Prune(key);
+      return true;
+    }
+  }
+  Unlock(leaf);
+  Retire(old);
+  return true;
+}
+
+auto ConcurrentBPlusTree::RemoveExpired(std::string_view key) -> size_t {
+  Leaf *leaf = LockLeaf(key, false);
+  bool found = false;
+  size_t index = Position(leaf, key, &found);
+  Record *old =
+      found ? leaf->records[index].load(std::memory_order_relaxed) : nullptr;
+  if (!old || !Expirer::Expired(old->deadline, Expirer::NowMs())) {
+    Unlock(leaf);
+    return 0;
+  }
+  size_t count = leaf->count.load(std::memory_order_relaxed);
+  for (size_t i = index + 1; i < count; ++i) {
+    leaf->records[i - 1].store(leaf->records[i].load(),
+                               std::memory_order_release);
+  }
+  leaf->records[count - 1].store(nullptr, std::memory_order_release);
+  leaf->count.store(count - 1, std::memory_order_release);
+  Unlock(leaf);
+  size_.fetch_sub(1);
+  Retire(old);
+  if (count == 1) Prune(key);
+  return 1;
+}
+
+// Исключает опустевший лист ключа key из родителя. Оба узла блокируются,
+// только если не менялись с момента спуска, поэтому читатели и писатели,
+// дошедшие до листа раньше, не пройдут проверку версии и повторят спуск.
+// Разделитель, как и лист, освобождается через эпоху: его могут держать
+// Snapshot::low и Snapshot::high.
+auto ConcurrentBPlusTree::Prune(std::string_view key) -> void {
+  EpochGuard guard;
+  while (true) {
+    Node *node = root_.load(std::memory_order_acquire);
+    uint64_t version = ReadLock(node);
+    if (node != root_.load(std::memory_order_acquire)) continue;
+    Inner *parent = nullptr;
+    uint64_t parent_version = 0;
+    size_t index = 0;
+    bool restart = false;
+    while (!node->leaf) {
+      auto *inner = static_cast<Inner *>(node);
+      size_t count = std::min(inner->count.load(std::memory_order_relaxed),
+                              kInnerKeys);
+      Node *child = nullptr;
+      if (Route(inner, count, key, false, &index))
+        child = inner->children[index].load(std::memory_order_acquire);
+      if (!child || !Validate(inner, version)) {
+        restart = true;
+        break;
+      }
+      parent = inner;
+      parent_version = version;
+      node = child;
+      version = ReadLock(child);
+      if (!Validate(inner, parent_version)) {
+        restart = true;
+        break;
+      }
+    }
+    if (restart) continue;
+    if (!parent) return;
+    if (!Upgrade(parent, parent_version)) continue;
+    if (!Upgrade(node, version)) {
+      Unlock(parent);
+      continue;
+    }
+    size_t count = parent->count.load(std::memory_order_relaxed);
+    if (node->count.load(std::memory_order_relaxed) != 0 || count == 0) {
+      Unlock(node);
+      Unlock(parent);
+      return;
+    }
+    size_t separator_index = index ? index - 1 : 0;
+    const std::string *separator =
+        parent->keys[separator_index].load(std::memory_order_relaxed);
+    for (size_t i = separator_index; i + 1 < count; ++i) {
+      parent->keys[i].store(parent->keys[i + 1].load(),
+                            std::memory_order_release);
+    }
+    for (size_t i = index; i < count; ++i) {
+      parent->children[i].store(parent->children[i + 1].load(),
+                                std::memory_order_release);
+    }
+    parent->keys[count - 1].store(nullptr, std::memory_order_release);
+    parent->children[count].store(nullptr, std::memory_order_release);
+    parent->count.store(count - 1, std::memory_order_release);
+    Unlock(node);
+    Unlock(parent);
+    EpochManager::Instance().Retire(node, [](void *object) {
+      delete static_cast<Leaf *>(static_cast<Node *>(object));
+    });
+    EpochManager::Instance().Retire(
+        const_cast<std::string *>(separator),
+        [](void *object) { delete static_cast<std::string *>(object); });
+    return;
+  }
+}
+
+auto ConcurrentBPlusTree::Set(Peer peer, int time_of_life) -> void {
+  int64_t deadline =
+      time_of_life > 0 ? Expirer::NowMs() + time_of_life * 1000LL : 0;
+  InsertRecord(new Record(std::move(peer), deadline), false);
+}
+
+auto ConcurrentBPlusTree::Get(const std::string &key) -> Peer * {
+  EpochGuard guard;
+  const Record *record = Lookup(key);
+  return record ? const_cast<Peer *>(&record->peer) : nullptr;
+}
+
+auto ConcurrentBPlusTree::GetCopy(const std::string &key, Peer *out) -> bool {
+  EpochGuard guard;
+  const Record *record = Lookup(key);
+  if (!record) return false;
+  *out = record->peer;
+  return true;
+}
+
+auto ConcurrentBPlusTree::Exists(const std::string &key) -> bool {
+  EpochGuard guard;
+  return Lookup(key) != nullptr;
+}
+
+auto ConcurrentBPlusTree::Del(const std::string &key) -> bool {
+  return ModifyLive(key, [](const Record &) -> Record * { return nullptr; });
+}
+
+auto ConcurrentBPlusTree::Update(const std::string &key,
+                                 const std::string &last_name,
+                                 const std::string &first_name,
+                                 int year_of_birth, const std::string &city,
+                                 int number_of_current_coins) -> void {
+  ModifyLive(key, [&](const Record &old) {
+    Peer peer = old.peer;
+    if (!last_name.empty()) peer.last_name = last_name;
+    if (!first_name.empty()) peer.first_name = first_name;
+    if (year_of_birth) peer.year_of_birth = year_of_birth;
+    if (!city.empty()) peer.city = city;
+    peer.number_of_current_coins = number_of_current_coins;
+    return new Record(std::move(peer), old.deadline);
+  });
+}
+
+auto ConcurrentBPlusTree::Rename(const std::string &key_old,
+                                 const std::string &key_new) -> void {
+  if (key_old == key_new) return;
+  Peer peer;
+  int64_t deadline = 0;
+  bool moved = ModifyLive(key_old, [&](const Record &old) -> Record * {
+    peer = old.peer;
+    deadline = old.deadline;
+    return nullptr;
+  });
+  if (!moved) return;
+  peer.key = key_new;
+  InsertRecord(new Record(std::move(peer), deadline), true);
+}
+
+auto ConcurrentBPlusTree::TTL(const std::string &key) -> int {
+  EpochGuard guard;
+  const Record *record = Lookup(key);
+  if (!record || !record->deadline) return 0;
+  return static_cast<int>((record->deadline - Expirer::NowMs() + 999) / 1000);
+}
+
+auto ConcurrentBPlusTree::Expire(const std::string &key, int seconds)
+    -> bool {
+  return PExpireAt(key, Expirer::NowMs() + std::max(seconds, 0) * 1000LL);
+}
+
+// Без срока жизни запись не меняется и новая версия не создаётся.
+auto ConcurrentBPlusTree::Persist(const std::string &key) -> bool {
+  Leaf *leaf = LockLeaf(key, false);
+  bool found = false;
+  size_t index = Position(leaf, key, &found);
+  Record *old =
+      found ? leaf->records[index].load(std::memory_order_relaxed) : nullptr;
+  if (!old || !old->deadline ||
+      Expirer::Expired(old->deadline, Expirer::NowMs())) {
+    Unlock(leaf);
+    return false;
+  }
+  leaf->records[index].store(new Record(old->peer, 0),
+                             std::memory_order_release);
+  Unlock(leaf);
+  Retire(old);
+  return true;
+}
+
+auto ConcurrentBPlusTree::PTTL(const std::string &key) -> int64_t {
+  EpochGuard guard;
+  const Record *record = Lookup(key);
+  if (!record) return -2;
+  if (!record->deadline) return -1;
+  return std::max<int64_t>(0, record->deadline - Expirer::NowMs());
+}
+
+auto ConcurrentBPlusTree::PExpireTime(const std::string &key) -> int64_t {
+  EpochGuard guard;
+  const Record *record = Lookup(key);
+  if (!record) return -2;
+  return record->deadline ? record->deadline : -1;
+}
+
+auto ConcurrentBPlusTree::PExpireAt(const std::string &key, int64_t deadline)
+    -> bool {
+  return ModifyLive(key, [deadline](const Record &old) -> Record * {
+    if (Expirer::Expired(deadline, Expirer::NowMs())) return nullptr;
+    return new Record(old.peer, deadline);
+  });
+}
+
+// Лист за листом: следующий лист ищется спуском по границе прочитанного,
+// поэтому расщепления между шагами не приводят к пропускам и повторам.
+auto ConcurrentBPlusTree::ScanRange(const std::string &from,
+                                    const std::string &to,
+                                    const Visitor &visit, bool reverse)
+    -> void {
+  EpochGuard guard;
+  Snapshot snapshot;
+  int64_t now = Expirer::NowMs();
+  auto live = [now](const Record *record) {
+    return !Expirer::Expired(record->deadline, now);
+  };
+  if (!reverse) {
+    std::string resume = from;
+    while (true) {
+      if (!ReadLeaf(resume, Seek::kAtOrAfter, &snapshot)) continue;
+      for (size_t i = 0; i < snapshot.count; ++i) {
+        const Record *record = snapshot.records[i];
+        if (record->peer.key.Compare(resume) < 0) continue;
+        if (!to.empty() && record->peer.key.Compare(to) >= 0) return;
+        if (live(record) && !visit(record->peer)) return;
+      }
+      if (!snapshot.high || (!to.empty() && *snapshot.high >= to)) return;
+      resume = *snapshot.high;
+    }
+  }
+  std::string resume = to;
+  Seek seek = to.empty() ? Seek::kLast : Seek::kBefore;
+  while (true) {
+    if (!ReadLeaf(resume, seek, &snapshot)) continue;
+    for (size_t i = snapshot.count; i-- > 0;) {
+      const Record *record = snapshot.records[i];
+      if (seek != Seek::kLast && record->peer.key.Compare(resume) >= 0)
+        continue;
+      if (record->peer.key.Compare(from) < 0) return;
+      if (live(record) && !visit(record->peer)) return;
+    }
+    if (!snapshot.low || *snapshot.low <= from) return;
+    resume = *snapshot.low;
+    seek = Seek::kBefore;
+  }
+}
+
+auto ConcurrentBPlusTree::Keys() -> std::vector<std::string> {
+  std::vector<std::string> result;
+  result.reserve(Size());
+  ScanRange("", "", [&result](const Peer &peer) {
+    result.push_back(peer.key);
+    return true;
+  });
+  return result;
+}
+
+auto ConcurrentBPlusTree::Find(const std::string &last_name,
+                               const std::string &first_name,
+                               int year_of_birth, const std::string &city,
+                               int number_of_current_coins)
+    -> std::vector<std::string> {
+  std::vector<std::string> result;
+  PeerFilter filter(last_name, first_name, year_of_birth, city,
+                    number_of_current_coins);
+  if (filter.Impossible()) return result;
+  ScanRange("", "", [&](const Peer &peer) {
+    if (filter(peer)) result.push_back(peer.key);
+    return true;
+  });
+  return result;
+}
+
+auto ConcurrentBPlusTree::ShowAll() -> std::vector<Peer *> {
+  std::vector<Peer *> result;
+  result.reserve(Size());
+  ScanRange("", "", [&result](const Peer &peer) {
+    result.push_back(const_cast<Peer *>(&peer));
+    return true;
+  });
+  return result;
+}
+
+auto ConcurrentBPlusTree::ActiveExpireCycle(std::chrono::microseconds budget)
+    -> size_t {
+  std::lock_guard<std::mutex> lock(expire_mutex_);
+  EpochGuard guard;
+  auto start = std::chrono::steady_clock::now();
+  size_t reclaimed = 0;
+  Snapshot snapshot;
+  std::vector<std::string> expired;
+  while (true) {
+    if (!ReadLeaf(expire_cursor_, Seek::kAtOrAfter, &snapshot)) continue;
+    int64_t now = Expirer::NowMs();
+    expired.clear();
+    for (size_t i = 0; i < snapshot.count; ++i) {
+      if (Expirer::Expired(snapshot.records[i]->deadline, now))
+        expired.push_back(snapshot.records[i]->peer.key);
+    }
+    for (const std::string &key : expired) reclaimed += RemoveExpired(key);
+    expire_cursor_ = snapshot.high ? *snapshot.high : "";
+    if (expire_cursor_.empty() ||
+        std::chrono::steady_clock::now() - start >= budget)
+      break;
+  }
+  return reclaimed;
+}
+
+// Хранилище потокобезопасно, поэтому разобранные куски файла вставляются
+// параллельно, каждый в своём потоке.
+auto ConcurrentBPlusTree::Upload(const std::string &data_directory) -> int {
+  auto batches = ParseRecords(data_directory);
+  int lines = RecordCount(batches);
+  WorkerPool::Instance().Run(batches.size(), [this, &batches](size_t i) {
+    for (Peer &peer : batches[i]) Set(std::move(peer));
+  });
+  return lines;
+}
+
+auto ConcurrentBPlusTree::ExportData(const std::string &data_directory)
+    -> int {
+  std::ofstream file(data_directory);
+  int lines = 0;
+  if (file.is_open()) {
+    ScanRange("", "", [&file, &lines](const Peer &peer) {
+      file << peer.key << " ";
+      file << peer.last_name << " ";
+      file << peer.first_name << " ";
+      file << peer.year_of_birth << " ";
+      file << peer.city << " ";
+      file << peer.number_of_current_coins << "\n";
+      ++lines;
+      return true;
+    });
+    file.close();
+  }
+  return lines;
+}
+
+}  // namespace s21
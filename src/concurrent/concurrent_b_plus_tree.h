@@ -0,0 +1,169 @@
+#ifndef A6_CONCURRENT_B_PLUS_TREE_H
+#define A6_CONCURRENT_B_PLUS_TREE_H
+
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "../other/key_value.h"
+#include "../other/ordered_key_value.h"
+#include "epoch.h"
+
+namespace s21 {
+
+/// @brief Потокобезопасное упорядоченное хранилище: B+дерево с
+/// оптимистичной блокировкой узлов (optimistic lock coupling). У каждого
+/// узла есть счётчик версий. Читатель спускается, не записывая в узлы
+/// ничего: запоминает версию узла, читает его и сверяет версию; если узел
+/// за это время менялся, спуск начинается заново. Писатель блокирует только
+/// изменяемый лист, а при расщеплении - ещё и родителя. Полные узлы
+/// расщепляются заранее, по дороге вниз, поэтому расщепление никогда не
+/// поднимается выше одного уровня.
+///
+/// Записи неизменяемы: изменение подставляет в лист новую версию, а старая
+/// освобождается через EpochManager, когда её уже никто не читает.
+/// Опустевший лист исключается из родителя под блокировкой обоих узлов и
+/// тоже освобождается через EpochManager; единственный потомок родителя
+/// остаётся на месте. Внутренние узлы не сливаются и живут до разрушения
+/// дерева.
+///
+/// ScanRange читает каждый лист целиком и согласованно, затем переходит к
+/// следующему спуском по границе листа. Ключ, который не менялся во время
+/// обхода, встретится ровно один раз.
+class ConcurrentBPlusTree : public OrderedKeyValue {
+ public:
+  ConcurrentBPlusTree();
+  ~ConcurrentBPlusTree() override;
+
+  ConcurrentBPlusTree(const ConcurrentBPlusTree &) = delete;
+  auto operator=(const ConcurrentBPlusTree &)
+      -> ConcurrentBPlusTree & = delete;
+
+  using KeyValue::Set;
+  auto Set(Peer peer, int time_of_life = 0) -> void override;
+  auto Get(const std::string &key) -> Peer * override;
+  auto GetCopy(const std::string &key, Peer *out) -> bool override;
+  auto Exists(const std::string &key) -> bool override;
+  auto Del(const std::string &key) -> bool override;
+  auto Update(const std::string &key, const std::string &last_name = "",
+              const std::string &first_name = "", int year_of_birth = 0,
+              const std::string &city = "", int number_of_current_coins = 0)
+      -> void override;
+  auto Keys() -> std::vector<std::string> override;
+  using OrderedKeyValue::Keys;
+
+  /// @brief Запись удаляется под старым ключом и вставляется под новым;
+  /// между этими шагами читатель не видит её ни под одним ключом.
+  /// @param key_old
+  /// @param key_new
+  auto Rename(const std::string &key_old, const std::string &key_new)
+      -> void override;
+  auto TTL(const std::string &key) -> int override;
+  auto Expire(const std::string &key, int seconds) -> bool override;
+  auto Persist(const std::string &key) -> bool override;
+  auto PTTL(const std::string &key) -> int64_t override;
+  auto PExpireTime(const std::string &key) -> int64_t override;
+  auto PExpireAt(const std::string &key, int64_t deadline) -> bool override;
+  auto Find(const std::string &last_name = "",
+            const std::string &first_name = "", int year_of_birth = 0,
+            const std::string &city = "", int number_of_current_coins = -1)
+      -> std::vector<std::string> override;
+  auto ShowAll() -> std::vector<Peer *> override;
+  auto ScanRange(const std::string &from, const std::string &to,
+                 const Visitor &visit, bool reverse = false) -> void override;
+
+  /// @brief Обходит листья с места прошлого вызова и удаляет истёкшие
+  /// записи, пока не исчерпан бюджет.
+  auto ActiveExpireCycle(
+      std::chrono::microseconds budget = std::chrono::milliseconds(1))
+      -> size_t override;
+  auto Upload(const std::string &data_directory) -> int override;
+  auto ExportData(const std::string &data_directory) -> int override;
+
+  /// @brief Число записей, включая истёкшие, но ещё не удалённые.
+  auto Size() const -> size_t { return size_.load(); }
+
+ private:
+  static constexpr size_t kLeafSlots = 32;
+  static constexpr size_t kInnerKeys = 31;
+
+  struct Record {
+    Record(Peer value, int64_t expires)
+        : peer(std::move(value)), deadline(expires) {}
+
+    Peer peer;
+    int64_t deadline;
+  };
+
+  /// Младший бит версии - признак блокировки; снятие блокировки
+  /// увеличивает версию.
+  struct Node {
+    explicit Node(bool is_leaf) : leaf(is_leaf) {}
+
+    std::atomic<uint64_t> version{0};
+    std::atomic<size_t> count{0};
+    const bool leaf;
+  };
+
+  struct Leaf : Node {
+    Leaf() : Node(true) {}
+
+    std::array<std::atomic<Record *>, kLeafSlots> records{};
+  };
+
+  /// Ключи поддерева children[i] лежат в [keys[i - 1], keys[i]).
+  /// Разделители неизменяемы и принадлежат узлу.
+  struct Inner : Node {
+    Inner() : Node(false) {}
+
+    std::array<std::atomic<const std::string *>, kInnerKeys> keys{};
+    std::array<std::atomic<Node *>, kInnerKeys + 1> children{};
+  };
+
+  enum class Seek { kAtOrAfter, kBefore, kLast };
+
+  /// Согласованная копия листа и границы его диапазона (nullptr - без
+  /// границы).
+  struct Snapshot {
+    std::array<const Record *, kLeafSlots> records;
+    size_t count = 0;
+    const std::string *low = nullptr;
+    const std::string *high = nullptr;
+  };
+
+  static auto ReadLock(const Node *node) -> uint64_t;
+  static auto Validate(const Node *node, uint64_t version) -> bool;
+  static auto Upgrade(Node *node, uint64_t version) -> bool;
+  static auto Unlock(Node *node) -> void;
+  static auto Route(const Inner *inner, size_t count, std::string_view key,
+                    bool strict, size_t *index) -> bool;
+  static auto Position(const Leaf *leaf, std::string_view key, bool *found)
+      -> size_t;
+  static auto Retire(Record *record) -> void;
+  static auto Destroy(Node *node) -> void;
+
+  auto ReadLeaf(std::string_view key, Seek seek, Snapshot *out) const -> bool;
+  auto Lookup(std::string_view key) const -> const Record *;
+  auto LockLeaf(std::string_view key, bool need_room) -> Leaf *;
+  auto TryLockLeaf(std::string_view key, bool need_room) -> Leaf *;
+  auto Split(Inner *parent, uint64_t parent_version, Node *node,
+             uint64_t version) -> void;
+  auto InsertRecord(Record *record, bool overwrite) -> void;
+  template <typename Make>
+  auto ModifyLive(std::string_view key, Make make) -> bool;
+  auto RemoveExpired(std::string_view key) -> size_t;
+  auto Prune(std::string_view key) -> void;
+
+  std::atomic<Node *> root_;
+  std::atomic<size_t> size_{0};
+  std::mutex expire_mutex_;
+  std::string expire_cursor_;
+};
+
+}  // namespace s21
+
+#endif  // A6_CONCURRENT_B_PLUS_TREE_H
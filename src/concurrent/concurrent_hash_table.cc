@@ -0,0 +1,394 @@
+#include "concurrent_hash_table.h"
+
+#include <algorithm>
+
+#include "../expiration/expirer.h"
+#include "../index/peer_filter.h"
+#include "../other/record_loader.h"
+#include "../other/worker_pool.h"
+
+namespace s21 {
+
+ConcurrentHashTable::ConcurrentHashTable()
+    : table_(new Table(kInitialBuckets)) {}
+
+// Разрушение допускается только после завершения всех потоков, которые
+// обращаются к таблице, поэтому записи освобождаются сразу.
+ConcurrentHashTable::~ConcurrentHashTable() { delete table_.load(); }
+
+ConcurrentHashTable::Table::~Table() {
+  for (size_t i = 0; i <= mask; ++i) {
+    Record *record = heads[i].load(std::memory_order_relaxed);
+    while (record) {
+      Record *next = record->next.load(std::memory_order_relaxed);
+      delete record;
+      record = next;
+    }
+  }
+}
+
+auto ConcurrentHashTable::Retire(Record *record) -> void {
+  EpochManager::Instance().Retire(
+      record, [](void *object) { delete static_cast<Record *>(object); });
+}
+
+// Пока идёт рост, полоса живёт в новой таблице, как только перенесена, и в
+// старой до этого. Писатель под блокировкой полосы видит её положение
+// неизменным.
+auto ConcurrentHashTable::Follow(Table *table, size_t stripe) -> Table * {
+  for (Table *next = table->next.load(std::memory_order_acquire);
+       next && table->moved[stripe].load(std::memory_order_acquire);
+       next = table->next.load(std::memory_order_acquire)) {
+    table = next;
+  }
+  return table;
+}
+
+// Чтение без блокировок: вызывающий должен находиться в эпохе.
+auto ConcurrentHashTable::Lookup(std::string_view key, uint64_t hash) const
+    -> const Record * {
+  const Table *table = Current(hash);
+  const Record *record =
+      table->heads[hash & table->mask].load(std::memory_order_acquire);
+  for (; record; record = record->next.load(std::memory_order_acquire)) {
+    if (record->hash == hash && record->peer.key.Equals(key)) {
+      if (Expirer::Expired(record->deadline, Expirer::NowMs())) return nullptr;
+      return record;
+    }
+  }
+  return nullptr;
+}
+
+// Вызывается под блокировкой полосы корзины.
+auto ConcurrentHashTable::FindLink(Table *table, std::string_view key,
+                                   uint64_t hash) -> Link {
+  std::atomic<Record *> *slot = &table->heads[hash & table->mask];
+  for (Record *record = slot->load(std::memory_order_relaxed); record;
+       record = slot->load(std::memory_order_relaxed)) {
+    if (record->hash == hash && record->peer.key.Equals(key))
+      return {slot, record};
+    slot = &record->next;
+  }
+  return {slot, nullptr};
+}
+
+// Подставляет новую версию записи на место старой одной атомарной записью.
+auto ConcurrentHashTable::Replace(const Link &link, Record *record) -> void {
+  record->next.store(link.record->next.load(std::memory_order_relaxed),
+                     std::memory_order_relaxed);
+  link.slot->store(record, std::memory_order_release);
+  Retire(link.record);
+}
+
+auto ConcurrentHashTable::Remove(const Link &link) -> void {
+  link.slot->store(link.record->next.load(std::memory_order_relaxed),
+                   std::memory_order_release);
+  Retire(link.record);
+  size_.fetch_sub(1);
+}
+
+auto ConcurrentHashTable::Set(Peer peer, int time_of_life) -> void {
+  uint64_t hash = HashKey(peer.key.View());
+  int64_t now = Expirer::NowMs();
+  int64_t deadline = time_of_life > 0 ? now + time_of_life * 1000LL : 0;
+  {
+    std::lock_guard<std::mutex> lock(Stripe(hash));
+    Link link = FindLink(Current(hash), peer.key.View(), hash);
+    if (link.record) {
+      if (!Expirer::Expired(link.record->deadline, now)) return;
+      Replace(link, new Record(std::move(peer), hash, deadline));
+      return;
+    }
+    auto *record = new Record(std::move(peer), hash, deadline);
+    link.slot->store(record, std::memory_order_release);
+    size_.fetch_add(1);
+  }
+  MaybeGrow();
+}
+
+auto ConcurrentHashTable::Get(const std::string &key) -> Peer * {
+  EpochGuard guard;
+  const Record *record = Lookup(key, HashKey(key));
+  return record ? const_cast<Peer *>(&record->peer) : nullptr;
+}
+
+auto ConcurrentHashTable::GetCopy(const std::string &key, Peer *out) -> bool {
+  EpochGuard guard;
+  const Record *record = Lookup(key, HashKey(key));
+  if (!record) return false;
+  *out = record->peer;
+  return true;
+}
+
+auto ConcurrentHashTable::Exists(const std::string &key) -> bool {
+  EpochGuard guard;
+  return Lookup(key, HashKey(key)) != nullptr;
+}
+
+auto ConcurrentHashTable::Del(const std::string &key) -> bool {
+  uint64_t hash = HashKey(key);
+  std::lock_guard<std::mutex> lock(Stripe(hash));
+  Link link = FindLink(Current(hash), key, hash);
+  if (!link.record) return false;
+  bool live = !Expirer::Expired(link.record->deadline, Expirer::NowMs());
+  Remove(link);
+  return live;
+}
+
+auto ConcurrentHashTable::Update(const std::string &key,
+                                 const std::string &last_name,
+                                 const std::string &first_name,
+                                 int year_of_birth, const std::string &city,
+                                 int number_of_current_coins) -> void {
+  uint64_t hash = HashKey(key);
+  std::lock_guard<std::mutex> lock(Stripe(hash));
+  Link link = FindLink(Current(hash), key, hash);
+  if (!link.record ||
+      Expirer::Expired(link.record->deadline, Expirer::NowMs()))
+    return;
+  Peer peer = link.record->peer;
+  if (!last_name.empty()) peer.last_name = last_name;
+  if (!first_name.empty()) peer.first_name = first_name;
+  if (year_of_birth) peer.year_of_birth = year_of_birth;
+  if (!city.empty()) peer.city = city;
+  peer.number_of_current_coins = number_of_current_coins;
+  Replace(link, new Record(std::move(peer), hash, link.record->deadline));
+}
+
+// Обе полосы блокируются вместе. Читатель может на мгновение увидеть
+// запись под обоими ключами или ни под одним.
+auto ConcurrentHashTable::Rename(const std::string &key_old,
+                                 const std::string &key_new) -> void {
+  if (key_old == key_new) return;
+  uint64_t hash_old = HashKey(key_old);
+  uint64_t hash_new = HashKey(key_new);
+  std::mutex &first = Stripe(hash_old);
+  std::mutex &second = Stripe(hash_new);
+  std::unique_lock<std::mutex> lock_first(first, std::defer_lock);
+  std::unique_lock<std::mutex> lock_second(second, std::defer_lock);
+  if (&first == &second) {
+    lock_first.lock();
+  } else {
+    std::lock(lock_first, lock_second);
+  }
+  int64_t now = Expirer::NowMs();
+  Link source = FindLink(Current(hash_old), key_old, hash_old);
+  if (!source.record || Expirer::Expired(source.record->deadline, now))
+    return;
+  Peer peer = source.record->peer;
+  int64_t deadline = source.record->deadline;
+  peer.key = key_new;
+  Link target = FindLink(Current(hash_new), key_new, hash_new);
+  if (target.record) {
+    Replace(target, new Record(std::move(peer), hash_new, deadline));
+  } else {
+    target.slot->store(new Record(std::move(peer), hash_new, deadline),
+                       std::memory_order_release);
+    size_.fetch_add(1);
+  }
+  Remove(FindLink(Current(hash_old), key_old, hash_old));
+}
+
+auto ConcurrentHashTable::TTL(const std::string &key) -> int {
+  EpochGuard guard;
+  const Record *record = Lookup(key, HashKey(key));
+  if (!record || !record->deadline) return 0;
+  return static_cast<int>((record->deadline - Expirer::NowMs() + 999) / 1000);
+}
+
+auto ConcurrentHashTable::Expire(const std::string &key, int seconds) -> bool {
+  return PExpireAt(key, Expirer::NowMs() + std::max(seconds, 0) * 1000LL);
+}
+
+auto ConcurrentHashTable::Persist(const std::string &key) -> bool {
+  uint64_t hash = HashKey(key);
+  std::lock_guard<std::mutex> lock(Stripe(hash));
+  Link link = FindLink(Current(hash), key, hash);
+  if (!link.record || !link.record->deadline ||
+      Expirer::Expired(link.record->deadline, Expirer::NowMs()))
+    return false;
+  Replace(link, new Record(link.record->peer, hash, 0));
+  return true;
+}
+
+auto ConcurrentHashTable::PTTL(const std::string &key) -> int64_t {
+  EpochGuard guard;
+  const Record *record = Lookup(key, HashKey(key));
+  if (!record) return -2;
+  if (!record->deadline) return -1;
+  return std::max<int64_t>(0, record->deadline - Expirer::NowMs());
+}
+
+auto ConcurrentHashTable::PExpireTime(const std::string &key) -> int64_t {
+  EpochGuard guard;
+  const Record *record = Lookup(key, HashKey(key));
+  if (!record) return -2;
+  return record->deadline ? record->deadline : -1;
+}
+
+auto ConcurrentHashTable::PExpireAt(const std::string &key, int64_t deadline)
+    -> bool {
+  uint64_t hash = HashKey(key);
+  std::lock_guard<std::mutex> lock(Stripe(hash));
+  Link link = FindLink(Current(hash), key, hash);
+  int64_t now = Expirer::NowMs();
+  if (!link.record || Expirer::Expired(link.record->deadline, now))
+    return false;
+  if (Expirer::Expired(deadline, now)) {
+    Remove(link);
+  } else {
+    Replace(link, new Record(link.record->peer, hash, deadline));
+  }
+  return true;
+}
+
+// Обход живых записей без блокировок. Корзина i уже перенесённой полосы
+// лежит в новой таблице корзинами i, i + размер старой и так далее.
+template <typename Func>
+auto ConcurrentHashTable::ForEach(Func func) const -> void {
+  EpochGuard guard;
+  int64_t now = Expirer::NowMs();
+  Table *table = table_.load(std::memory_order_acquire);
+  for (size_t i = 0; i <= table->mask; ++i) {
+    const Table *current = Follow(table, i & (kStripes - 1));
+    for (size_t j = i; j <= current->mask; j += table->mask + 1) {
+      for (const Record *record =
+               current->heads[j].load(std::memory_order_acquire);
+           record; record = record->next.load(std::memory_order_acquire)) {
+        if (!Expirer::Expired(record->deadline, now)) func(*record);
+      }
+    }
+  }
+}
+
+auto ConcurrentHashTable::Keys() -> std::vector<std::string> {
+  std::vector<std::string> result;
+  result.reserve(Size());
+  ForEach([&result](const Record &record) {
+    result.push_back(record.peer.key);
+  });
+  return result;
+}
+
+auto ConcurrentHashTable::Find(const std::string &last_name,
+                               const std::string &first_name,
+                               int year_of_birth, const std::string &city,
+                               int number_of_current_coins)
+    -> std::vector<std::string> {
+  std::vector<std::string> result;
+  PeerFilter filter(last_name, first_name, year_of_birth, city,
+                    number_of_current_coins);
+  if (filter.Impossible()) return result;
+  ForEach([&](const Record &record) {
+    if (filter(record.peer)) result.push_back(record.peer.key);
+  });
+  return result;
+}
+
+auto ConcurrentHashTable::ShowAll() -> std::vector<Peer *> {
+  std::vector<Peer *> result;
+  result.reserve(Size());
+  ForEach([&result](const Record &record) {
+    result.push_back(const_cast<Peer *>(&record.peer));
+  });
+  return result;
+}
+
+auto ConcurrentHashTable::ActiveExpireCycle(std::chrono::microseconds budget)
+    -> size_t {
+  // Без эпохи таблицу могли бы освободить после параллельного роста ещё до
+  // чтения её размера.
+  EpochGuard guard;
+  auto start = std::chrono::steady_clock::now();
+  size_t reclaimed = 0;
+  size_t buckets = table_.load()->mask + 1;
+  for (size_t step = 0; step < buckets; ++step) {
+    if (step % 64 == 0 && std::chrono::steady_clock::now() - start > budget)
+      break;
+    size_t bucket = expire_cursor_.fetch_add(1);
+    std::lock_guard<std::mutex> lock(Stripe(bucket));
+    Table *table = Current(bucket);
+    std::atomic<Record *> *slot = &table->heads[bucket & table->mask];
+    int64_t now = Expirer::NowMs();
+    while (Record *record = slot->load(std::memory_order_relaxed)) {
+      if (Expirer::Expired(record->deadline, now)) {
+        Remove({slot, record});
+        ++reclaimed;
+      } else {
+        slot = &record->next;
+      }
+    }
+  }
+  return reclaimed;
+}
+
+// Рост в два раза, когда записей больше, чем корзин. Растит один поток,
+// остальные продолжают работу. Полосы переносятся по одной под своей
+// блокировкой, так что писатели ждут только перенос своей полосы. Записи
+// копируются: по старым цепочкам ещё могут идти читатели, поэтому их
+// ссылки менять нельзя; старые цепочки освобождаются вместе со старой
+// таблицей.
+auto ConcurrentHashTable::MaybeGrow() -> void {
+  std::unique_lock<std::mutex> grow(grow_mutex_, std::try_to_lock);
+  if (!grow.owns_lock()) return;
+  // table_ меняет только растущий поток, поэтому таблицу не освободят.
+  Table *table = table_.load(std::memory_order_acquire);
+  if (size_.load() <= table->mask + 1) return;
+  auto *grown = new Table(2 * (table->mask + 1));
+  table->next.store(grown, std::memory_order_release);
+  for (size_t stripe = 0; stripe < kStripes; ++stripe) {
+    std::lock_guard<std::mutex> lock(stripes_[stripe]);
+    int64_t now = Expirer::NowMs();
+    for (size_t i = stripe; i <= table->mask; i += kStripes) {
+      for (Record *record = table->heads[i].load(std::memory_order_relaxed);
+           record; record = record->next.load(std::memory_order_relaxed)) {
+        if (Expirer::Expired(record->deadline, now)) {
+          size_.fetch_sub(1);
+          continue;
+        }
+        auto &head = grown->heads[record->hash & grown->mask];
+        auto *copy = new Record(record->peer, record->hash, record->deadline);
+        copy->next.store(head.load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+        head.store(copy, std::memory_order_relaxed);
+      }
+    }
+    table->moved[stripe].store(true, std::memory_order_release);
+  }
+  table_.store(grown, std::memory_order_release);
+  EpochManager::Instance().Retire(
+      table, [](void *object) { delete static_cast<Table *>(object); });
+}
+
+// Хранилище потокобезопасно, поэтому разобранные куски файла вставляются
+// параллельно, каждый в своём потоке.
+auto ConcurrentHashTable::Upload(const std::string &data_directory) -> int {
+  auto batches = ParseRecords(data_directory);
+  int lines = RecordCount(batches);
+  WorkerPool::Instance().Run(batches.size(), [this, &batches](size_t i) {
+    for (Peer &peer : batches[i]) Set(std::move(peer));
+  });
+  return lines;
+}
+
+auto ConcurrentHashTable::ExportData(const std::string &data_directory)
+    -> int {
+  std::ofstream file(data_directory);
+  int lines = 0;
+  if (file.is_open()) {
+    ForEach([&file, &lines](const Record &record) {
+      const Peer &peer = record.peer;
+      file << peer.key << " ";
+      file << peer.last_name << " ";
+      file << peer.first_name << " ";
+      file << peer.year_of_birth << " ";
+      file << peer.city << " ";
+      file << peer.number_of_current_coins << "\n";
+      ++lines;
+    });
+    file.close();
+  }
+  return lines;
+}
+
+}  // namespace s21
@@ -0,0 +1,142 @@
+#ifndef A6_CONCURRENT_HASH_TABLE_H
+#define A6_CONCURRENT_HASH_TABLE_H
+
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+#include "../other/hash.h"
+#include "../other/key_value.h"
+#include "epoch.h"
+
+namespace s21 {
+
+/// @brief Потокобезопасная хеш-таблица с чтением без блокировок. Корзины -
+/// односвязные списки неизменяемых записей, опубликованных атомарными
+/// указателями. Get, Exists, TTL, PTTL, Keys, Find и GetCopy только читают
+/// эти указатели внутри эпохи (EpochGuard). Писатели берут блокировку
+/// полосы корзин и заменяют запись целиком: новая версия подставляется
+/// одной атомарной записью, старая уходит в EpochManager::Retire и
+/// освобождается, когда её уже не может читать ни один поток. Таблица
+/// растёт по полосам: рост переносит в новую таблицу одну полосу за другой,
+/// блокируя только её, а остальные полосы тем временем доступны.
+///
+/// Истёкшие записи читатели считают отсутствующими; удаляют их писатели
+/// по ходу работы и ActiveExpireCycle.
+///
+/// Указатели из Get и ShowAll защищены только эпохой: запись, которую
+/// изменили или удалили, освобождается, как только её не читает ни один
+/// поток в эпохе. Вне EpochGuard вызывающего указатель может стать
+/// недействительным в любой момент, поэтому при параллельных изменениях
+/// используйте GetCopy.
+class ConcurrentHashTable : public KeyValue {
+ public:
+  ConcurrentHashTable();
+  ~ConcurrentHashTable() override;
+
+  ConcurrentHashTable(const ConcurrentHashTable &) = delete;
+  auto operator=(const ConcurrentHashTable &)
+      -> ConcurrentHashTable & = delete;
+
+  using KeyValue::Set;
+  auto Set(Peer peer, int time_of_life = 0) -> void override;
+  auto Get(const std::string &key) -> Peer * override;
+  auto GetCopy(const std::string &key, Peer *out) -> bool override;
+  auto Exists(const std::string &key) -> bool override;
+  auto Del(const std::string &key) -> bool override;
+  auto Update(const std::string &key, const std::string &last_name = "",
+              const std::string &first_name = "", int year_of_birth = 0,
+              const std::string &city = "", int number_of_current_coins = 0)
+      -> void override;
+  auto Keys() -> std::vector<std::string> override;
+  auto Rename(const std::string &key_old, const std::string &key_new)
+      -> void override;
+  auto TTL(const std::string &key) -> int override;
+  auto Expire(const std::string &key, int seconds) -> bool override;
+  auto Persist(const std::string &key) -> bool override;
+  auto PTTL(const std::string &key) -> int64_t override;
+  auto PExpireTime(const std::string &key) -> int64_t override;
+  auto PExpireAt(const std::string &key, int64_t deadline) -> bool override;
+  auto Find(const std::string &last_name = "",
+            const std::string &first_name = "", int year_of_birth = 0,
+            const std::string &city = "", int number_of_current_coins = -1)
+      -> std::vector<std::string> override;
+  auto ShowAll() -> std::vector<Peer *> override;
+
+  /// @brief Обходит корзины с места прошлого вызова и удаляет истёкшие
+  /// записи, пока не исчерпан бюджет.
+  auto ActiveExpireCycle(
+      std::chrono::microseconds budget = std::chrono::milliseconds(1))
+      -> size_t override;
+  auto Upload(const std::string &data_directory) -> int override;
+  auto ExportData(const std::string &data_directory) -> int override;
+
+  auto Size() const -> size_t { return size_.load(); }
+
+ private:
+  static constexpr size_t kStripes = 256;
+  static constexpr size_t kInitialBuckets = 1024;
+
+  struct Record {
+    Record(Peer value, uint64_t key_hash, int64_t expires)
+        : peer(std::move(value)), hash(key_hash), deadline(expires) {}
+
+    Peer peer;
+    uint64_t hash;
+    int64_t deadline;
+    std::atomic<Record *> next{nullptr};
+  };
+
+  struct Table {
+    explicit Table(size_t buckets)
+        : heads(new std::atomic<Record *>[buckets]()), mask(buckets - 1) {}
+    ~Table();
+
+    std::unique_ptr<std::atomic<Record *>[]> heads;
+    size_t mask;
+    /// Таблица, в которую идёт рост, и полосы, уже перенесённые в неё.
+    std::atomic<Table *> next{nullptr};
+    std::array<std::atomic<bool>, kStripes> moved{};
+  };
+
+  /// Ссылка на запись в цепочке: через неё запись заменяется или
+  /// исключается.
+  struct Link {
+    std::atomic<Record *> *slot;
+    Record *record;
+  };
+
+  static auto HashKey(std::string_view key) -> uint64_t {
+    return HashBytes(key.data(), key.size());
+  }
+  auto Stripe(uint64_t hash) -> std::mutex & {
+    return stripes_[hash & (kStripes - 1)];
+  }
+  static auto Follow(Table *table, size_t stripe) -> Table *;
+  auto Current(uint64_t hash) const -> Table * {
+    return Follow(table_.load(std::memory_order_acquire),
+                  hash & (kStripes - 1));
+  }
+  auto Lookup(std::string_view key, uint64_t hash) const -> const Record *;
+  auto FindLink(Table *table, std::string_view key, uint64_t hash) -> Link;
+  auto Replace(const Link &link, Record *record) -> void;
+  auto Remove(const Link &link) -> void;
+  auto MaybeGrow() -> void;
+  static auto Retire(Record *record) -> void;
+  template <typename Func>
+  auto ForEach(Func func) const -> void;
+
+  std::atomic<Table *> table_;
+  std::atomic<size_t> size_{0};
+  std::atomic<size_t> expire_cursor_{0};
+  std::array<std::mutex, kStripes> stripes_;
+  std::mutex grow_mutex_;
+};
+
+}  // namespace s21
+
+#endif  // A6_CONCURRENT_HASH_TABLE_H
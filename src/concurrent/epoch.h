@@ -0,0 +1,179 @@
+#ifndef A6_EPOCH_H
+#define A6_EPOCH_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace s21 {
+
+/// @brief Освобождение памяти по эпохам (EBR). Читатель входит в эпоху на
+/// время обращения к разделяемой структуре (EpochGuard) и не берёт
+/// блокировок. Писатель, исключивший объект из структуры, передаёт его в
+/// Retire; объект освобождается, когда глобальная эпоха продвинется на две
+/// ступени, то есть когда все читатели, которые могли его видеть, уже
+/// вышли. Отложенные объекты копятся в списке своего потока без
+/// блокировок; раз в kCollectEvery вызовов поток сам продвигает эпоху и
+/// освобождает готовые. Общий список под мьютексом получает только остатки
+/// завершившихся потоков, целой пачкой.
+class EpochManager {
+ public:
+  using Deleter = void (*)(void *);
+
+  static constexpr size_t kMaxThreads = 256;
+
+  static auto Instance() -> EpochManager & {
+    static EpochManager manager;
+    return manager;
+  }
+
+  EpochManager(const EpochManager &) = delete;
+  auto operator=(const EpochManager &) -> EpochManager & = delete;
+
+  ~EpochManager() {
+    for (auto &item : orphans_) item.deleter(item.object);
+  }
+
+  auto Enter() -> void {
+    ThreadState &state = Local();
+    if (state.depth++ == 0) {
+      uint64_t epoch = global_.load();
+      slots_[state.slot].epoch.store(epoch);
+    }
+  }
+
+  auto Exit() -> void {
+    ThreadState &state = Local();
+    if (--state.depth == 0) slots_[state.slot].epoch.store(kIdle);
+  }
+
+  /// @brief Откладывает освобождение объекта, уже недостижимого из
+  /// структуры.
+  auto Retire(void *object, Deleter deleter) -> void {
+    ThreadState &state = Local();
+    state.limbo.push_back({object, deleter, global_.load()});
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    if (state.limbo.size() < state.collect_at) return;
+    if (has_orphans_.load(std::memory_order_acquire)) Adopt(&state.limbo);
+    TryAdvance();
+    Collect(&state.limbo);
+    // Если читатель надолго задержался в эпохе, список не сокращается;
+    // следующий сбор откладывается, чтобы не проходить его на каждом вызове.
+    state.collect_at = state.limbo.size() + kCollectEvery;
+  }
+
+  /// @brief Число объектов, ожидающих освобождения.
+  auto Pending() const -> size_t {
+    return pending_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint64_t kIdle = 0;
+  static constexpr unsigned kCollectEvery = 64;
+
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> epoch{kIdle};
+    std::atomic<bool> used{false};
+  };
+
+  struct Item {
+    void *object;
+    Deleter deleter;
+    uint64_t epoch;
+  };
+
+  /// Место потока в таблице слотов; освобождается при завершении потока.
+  struct ThreadState {
+    explicit ThreadState(EpochManager &owner) : manager(owner) {
+      for (size_t i = 0; i < kMaxThreads; ++i) {
+        bool expected = false;
+        if (owner.slots_[i].used.compare_exchange_strong(expected, true)) {
+          slot = i;
+          return;
+        }
+      }
+      throw std::length_error("EpochManager: too many threads");
+    }
+    ~ThreadState() {
+      manager.slots_[slot].epoch.store(kIdle);
+      manager.slots_[slot].used.store(false);
+      if (limbo.empty()) return;
+      std::lock_guard<std::mutex> lock(manager.mutex_);
+      manager.orphans_.insert(manager.orphans_.end(), limbo.begin(),
+                              limbo.end());
+      manager.has_orphans_.store(true, std::memory_order_release);
+    }
+
+    EpochManager &manager;
+    size_t slot = 0;
+    unsigned depth = 0;
+    std::vector<Item> limbo;
+    size_t collect_at = kCollectEvery;
+  };
+
+  EpochManager() = default;
+
+  auto Local() -> ThreadState & {
+    thread_local ThreadState state(*this);
+    return state;
+  }
+
+  // Эпоха продвигается, только если все активные читатели уже в текущей.
+  auto TryAdvance() -> void {
+    uint64_t epoch = global_.load();
+    for (const Slot &slot : slots_) {
+      uint64_t seen = slot.epoch.load();
+      if (seen != kIdle && seen != epoch) return;
+    }
+    global_.compare_exchange_strong(epoch, epoch + 1);
+  }
+
+  // Освобождает объекты, которые уже не видит ни один читатель.
+  auto Collect(std::vector<Item> *limbo) -> void {
+    uint64_t safe = global_.load();
+    size_t kept = 0;
+    for (Item &item : *limbo) {
+      if (item.epoch + 2 <= safe) {
+        item.deleter(item.object);
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+      } else {
+        (*limbo)[kept++] = item;
+      }
+    }
+    limbo->resize(kept);
+  }
+
+  // Забирает остатки завершившихся потоков в список текущего.
+  auto Adopt(std::vector<Item> *limbo) -> void {
+    std::vector<Item> orphans;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      orphans.swap(orphans_);
+      has_orphans_.store(false, std::memory_order_relaxed);
+    }
+    limbo->insert(limbo->end(), orphans.begin(), orphans.end());
+  }
+
+  std::atomic<uint64_t> global_{1};
+  std::array<Slot, kMaxThreads> slots_;
+  std::atomic<size_t> pending_{0};
+  std::atomic<bool> has_orphans_{false};
+  std::mutex mutex_;
+  std::vector<Item> orphans_;
+};
+
+/// @brief Пребывание потока в эпохе на время жизни объекта.
+class EpochGuard {
+ public:
+  EpochGuard() { EpochManager::Instance().Enter(); }
+  ~EpochGuard() { EpochManager::Instance().Exit(); }
+  EpochGuard(const EpochGuard &) = delete;
+  auto operator=(const EpochGuard &) -> EpochGuard & = delete;
+};
+
+}  // namespace s21
+
+#endif  // A6_EPOCH_H
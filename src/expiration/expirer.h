@@ -0,0 +1,110 @@
+#ifndef A6_EXPIRER_H
+#define A6_EXPIRER_H
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "timing_wheel.h"
+
+namespace s21 {
+
+/// @brief Активное удаление истёкших ключей поверх TimingWheel.
+///
+/// Хранилище проверяет срок записи при каждом обращении к ней (ленивое
+/// истечение), а Expirer в фоне освобождает память ключей, к которым никто
+/// не обращается. Цикл запускается кооперативно раз в несколько операций,
+/// обрабатывает напоминания пачками и останавливается по бюджету времени.
+/// Если цикл упёрся в бюджет, а доля действительно истёкших ключей велика,
+/// следующие циклы запускаются чаще и работают дольше; когда очередь
+/// разобрана, усилие снижается.
+class Expirer {
+ public:
+  static constexpr unsigned kTickOps = 64;
+  static constexpr size_t kBatch = 20;
+  static constexpr unsigned kMaxEffort = 16;
+  static constexpr std::chrono::microseconds kCycleBudget{250};
+
+  static auto NowMs() -> int64_t { return TimingWheel::NowMs(); }
+
+  static auto Expired(int64_t deadline, int64_t now) -> bool {
+    return deadline && deadline <= now;
+  }
+
+  auto Schedule(const std::string &key, int64_t deadline) -> void {
+    if (deadline) wheel_.Schedule(key, deadline);
+  }
+
+  /// @brief Кооперативный шаг: вызывается хранилищем на каждой операции и
+  /// время от времени запускает Cycle.
+  /// @param reclaim функция bool(key, deadline), удаляющая запись, если её
+  /// срок всё ещё равен deadline
+  template <typename Reclaim>
+  auto Tick(Reclaim &&reclaim) -> void {
+    if (++ops_ < kTickOps / effort_) return;
+    ops_ = 0;
+    Cycle(reclaim, kCycleBudget * effort_);
+  }
+
+  /// @brief Цикл активного истечения, ограниченный бюджетом времени.
+  /// @param reclaim
+  /// @param budget
+  /// @return Число удалённых записей
+  template <typename Reclaim>
+  auto Cycle(Reclaim &&reclaim, std::chrono::microseconds budget) -> size_t {
+    auto start = std::chrono::steady_clock::now();
+    int64_t now = NowMs();
+    size_t seen = 0;
+    size_t expired = 0;
+    bool backlog = false;
+    auto callback = [&reclaim, &expired](const std::string &key,
+                                         int64_t deadline) {
+      if (reclaim(key, deadline)) ++expired;
+    };
+    while (true) {
+      size_t batch = wheel_.Advance(now, callback, kBatch);
+      seen += batch;
+      if (batch < kBatch) break;
+      if (std::chrono::steady_clock::now() - start >= budget) {
+        backlog = wheel_.HasDue();
+        break;
+      }
+    }
+    if (backlog && expired * 4 >= seen) {
+      effort_ = std::min(effort_ * 2, kMaxEffort);
+    } else if (!backlog) {
+      effort_ = std::max(effort_ / 2, 1u);
+    }
+    return expired;
+  }
+
+  /// @brief Удаляет все записи, срок которых уже наступил, без
+  /// ограничения по времени. Нужен операциям, которые считают позиции
+  /// записей и не могут пропускать истёкшие записи по одной.
+  /// @param reclaim
+  /// @return Число удалённых записей
+  template <typename Reclaim>
+  auto Drain(Reclaim &&reclaim) -> size_t {
+    int64_t now = NowMs();
+    size_t expired = 0;
+    auto callback = [&reclaim, &expired](const std::string &key,
+                                         int64_t deadline) {
+      if (reclaim(key, deadline)) ++expired;
+    };
+    while (wheel_.Advance(now, callback, kBatch) == kBatch) {
+    }
+    return expired;
+  }
+
+  auto Effort() const -> unsigned { return effort_; }
+  auto Clear() -> void { wheel_.Clear(); }
+
+ private:
+  TimingWheel wheel_;
+  unsigned ops_ = 0;
+  unsigned effort_ = 1;
+};
+
+}  // namespace s21
+
+#endif  // A6_EXPIRER_H
@@ -0,0 +1,88 @@
+#include "timing_wheel.h"
+
+#include <algorithm>
+
+namespace s21 {
+
+auto TimingWheel::Schedule(const std::string &key, int64_t deadline) -> void {
+  Bucket pending;
+  pending.push_back({key, deadline});
+  Place(pending, pending.begin());
+  ++size_;
+}
+
+auto TimingWheel::Advance(int64_t now, const Callback &callback, size_t limit)
+    -> size_t {
+  if (size_ == 0) {
+    current_ = std::max(current_, now + 1);
+    return 0;
+  }
+  while (current_ <= now) {
+    unsigned slot = static_cast<unsigned>(current_) & (kSlots - 1);
+    if (slot == 0) Cascade(1);
+    Bucket &bucket = wheel_[0][slot];
+    if (!bucket.empty()) {
+      due_.splice(due_.end(), bucket);
+      occupied_[0] &= ~(uint64_t{1} << slot);
+    }
+    current_ = NextTick(now);
+  }
+  size_t count = 0;
+  for (; count < limit && !due_.empty(); ++count) {
+    Entry entry = std::move(due_.front());
+    due_.pop_front();
+    --size_;
+    callback(entry.key, entry.deadline);
+  }
+  return count;
+}
+
+auto TimingWheel::Clear() -> void {
+  for (auto &level : wheel_)
+    for (auto &bucket : level) bucket.clear();
+  occupied_.fill(0);
+  due_.clear();
+  size_ = 0;
+}
+
+// Ячейка выбирается по старшим разрядам срока на том уровне, чей диапазон
+// вмещает оставшееся время. При проходе границы уровня ячейка каскадом
+// раскладывается по более мелким уровням.
+auto TimingWheel::Place(Bucket &from, Bucket::iterator it) -> void {
+  int64_t expires = std::max(it->deadline, current_);
+  int64_t delta = expires - current_;
+  unsigned level = 0;
+  while (level + 1 < kLevels &&
+         delta >= (int64_t{1} << (kSlotBits * (level + 1))))
+    ++level;
+  int64_t range = int64_t{1} << (kSlotBits * kLevels);
+  if (delta >= range) expires = current_ + range - 1;
+  unsigned slot =
+      static_cast<unsigned>(expires >> (kSlotBits * level)) & (kSlots - 1);
+  Bucket &bucket = wheel_[level][slot];
+  bucket.splice(bucket.end(), from, it);
+  occupied_[level] |= uint64_t{1} << slot;
+}
+
+auto TimingWheel::Cascade(unsigned level) -> void {
+  unsigned slot =
+      static_cast<unsigned>(current_ >> (kSlotBits * level)) & (kSlots - 1);
+  if (slot == 0 && level + 1 < kLevels) Cascade(level + 1);
+  Bucket &bucket = wheel_[level][slot];
+  occupied_[level] &= ~(uint64_t{1} << slot);
+  while (!bucket.empty()) Place(bucket, bucket.begin());
+}
+
+// Пропускает пустые ячейки нижнего уровня до ближайшей занятой ячейки или до
+// границы, на которой нужен каскад.
+auto TimingWheel::NextTick(int64_t now) const -> int64_t {
+  int64_t next = current_ + 1;
+  unsigned slot = static_cast<unsigned>(next) & (kSlots - 1);
+  if (slot == 0) return next;
+  uint64_t ahead = occupied_[0] >> slot;
+  int64_t target = ahead ? next + __builtin_ctzll(ahead)
+                         : (next | int64_t{kSlots - 1}) + 1;
+  return std::min(target, now + 1);
+}
+
+}  // namespace s21
@@ -0,0 +1,85 @@
+#ifndef A6_TIMING_WHEEL_H
+#define A6_TIMING_WHEEL_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+
+namespace s21 {
+
+/// @brief Иерархическое колесо таймеров для истечения срока жизни ключей.
+/// Сроки задаются абсолютным временем монотонных часов в миллисекундах.
+/// Колесо состоит из kLevels уровней по kSlots ячеек; ячейка уровня L
+/// покрывает kSlots^L миллисекунд. При продвижении времени обрабатываются
+/// только ячейки, срок которых наступил, поэтому стоимость не зависит от
+/// общего числа ключей с ограниченным временем жизни.
+///
+/// Сам срок хранится в записи хранилища, а колесо лишь напоминает о нём.
+/// Записи в колесе не отменяются: при срабатывании хранилище сравнивает
+/// срок из колеса со сроком записи и игнорирует устаревшие напоминания
+/// (после Del, Persist, Expire или повторного Set).
+class TimingWheel {
+ public:
+  using Callback = std::function<void(const std::string &, int64_t)>;
+
+  static constexpr unsigned kSlotBits = 6;
+  static constexpr unsigned kSlots = 1u << kSlotBits;
+  static constexpr unsigned kLevels = 6;
+
+  explicit TimingWheel(int64_t now = NowMs()) : current_(now) {}
+
+  /// @brief Текущее время монотонных часов в миллисекундах.
+  static auto NowMs() -> int64_t {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /// @brief Добавляет напоминание о сроке истечения ключа.
+  /// @param key
+  /// @param deadline абсолютное время в миллисекундах
+  auto Schedule(const std::string &key, int64_t deadline) -> void;
+
+  /// @brief Продвигает колесо до момента now и вызывает callback(key,
+  /// deadline) не более чем для limit напоминаний, срок которых наступил.
+  /// Необработанные напоминания остаются в очереди до следующего вызова.
+  /// @param now
+  /// @param callback
+  /// @param limit
+  /// @return Число сработавших напоминаний
+  auto Advance(int64_t now, const Callback &callback,
+               size_t limit = static_cast<size_t>(-1)) -> size_t;
+
+  /// @brief Есть ли наступившие, но ещё не обработанные напоминания.
+  auto HasDue() const -> bool { return !due_.empty(); }
+
+  auto Size() const -> size_t { return size_; }
+  auto Empty() const -> bool { return size_ == 0; }
+  auto Clear() -> void;
+
+ private:
+  struct Entry {
+    std::string key;
+    int64_t deadline;
+  };
+
+  using Bucket = std::list<Entry>;
+
+  auto Place(Bucket &from, Bucket::iterator it) -> void;
+  auto Cascade(unsigned level) -> void;
+  auto NextTick(int64_t now) const -> int64_t;
+
+  std::array<std::array<Bucket, kSlots>, kLevels> wheel_;
+  std::array<uint64_t, kLevels> occupied_{};
+  Bucket due_;
+  size_t size_ = 0;
+  /// Ближайший ещё не обработанный тик.
+  int64_t current_;
+};
+
+}  // namespace s21
+
+#endif  // A6_TIMING_WHEEL_H
@@ -1,282 +1,504 @@
 #include "hash_table.h"
 
 #include <algorithm>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "../other/record_loader.h"
 
 namespace s21 {
 
-auto HashTable::Rehash() -> void {
-  deleted_ = 0;
-  size_ = 0;
-  std::vector<Node *> newArr(capacity_);
-  std::list<std::pair<Node *, time_t>> newList(std::move(timer_));
-  std::swap(arr_, newArr);
-  for (auto &iter : newList) {
-    if (iter.first && iter.first->state) {
-      Set(iter.first->peer, iter.second);
-    }
-  }
-  for (size_t i = 0; i < newArr.size(); ++i) {
-    if (newArr[i] && newArr[i]->state) Set(newArr[i]->peer);
-  }
-  ClearArr(newArr);
-}
+namespace {
+
+/// Группа из 16 управляющих байтов, которая проверяется за одну SSE2
+/// операцию. Без SSE2 используется побайтовая проверка.
+class Group {
+ public:
+  static constexpr size_t kWidth = 16;
 
-auto HashTable::Set(const Peer &peer, int time_of_life) -> void {
-  UpdateTimer();
-  if (size_ + 1 > static_cast<int>(kResizeCoef * capacity_)) {
-    Resize();
-  } else if (deleted_ > size_) {
-    Rehash();
+  explicit Group(const int8_t *ctrl) {
+#ifdef __SSE2__
+    ctrl_ = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+#else
+    std::memcpy(ctrl_, ctrl, kWidth);
+#endif
   }
-  int h1 = Hash1(peer.key);
-  int h2 = Hash2(peer.key);
-  int i = 0;
-  int first_deleted = -1;
-  while (arr_[h1] && i < capacity_) {
-    if (arr_[h1]->peer.key == peer.key && arr_[h1]->state) {
-      return;
-    }
-    if (!arr_[h1]->state && first_deleted == -1) {
-      first_deleted = h1;
-    }
-    h1 = (h1 + h2) % capacity_;
-    ++i;
+
+  auto Match(int8_t h2) const -> uint32_t {
+#ifdef __SSE2__
+    return static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kWidth; ++i)
+      if (ctrl_[i] == h2) mask |= 1u << i;
+    return mask;
+#endif
   }
-  if (first_deleted == -1) {
-    arr_[h1] = new Node(peer);
-    if (time_of_life > 0) timer_.emplace_back(arr_[h1], time_of_life);
-  } else {
-    arr_[first_deleted]->peer = peer;
-    arr_[first_deleted]->state = true;
-    --deleted_;
-    if (time_of_life > 0)
-      timer_.emplace_back(arr_[first_deleted], time_of_life);
+
+  auto MatchEmpty() const -> uint32_t { return Match(-128); }
+
+  auto MatchEmptyOrDeleted() const -> uint32_t {
+#ifdef __SSE2__
+    return static_cast<uint32_t>(_mm_movemask_epi8(ctrl_));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kWidth; ++i)
+      if (ctrl_[i] < 0) mask |= 1u << i;
+    return mask;
+#endif
   }
-  ++size_;
+
+ private:
+#ifdef __SSE2__
+  __m128i ctrl_;
+#else
+  int8_t ctrl_[kWidth];
+#endif
+};
+
+auto LowestBit(uint32_t mask) -> size_t {
+  return static_cast<size_t>(__builtin_ctz(mask));
 }
 
-auto HashTable::Get(const std::string &key) -> Peer * {
-  UpdateTimer();
-  Node *node = FindNode(key);
-  if (node && node->state) return &node->peer;
-  return nullptr;
+}  // namespace
+
+auto HashTable::Set(Peer peer, int time_of_life) -> void {
+  Tick();
+  RehashStep();
+  uint64_t hash = HashKey(peer.key.View());
+  if (LocateLive(peer.key.View(), hash)) return;
+  int64_t deadline =
+      time_of_life > 0 ? Expirer::NowMs() + time_of_life * 1000LL : 0;
+  Track(peer);
+  expiry_.Schedule(peer.key, deadline);
+  InsertNew(std::move(peer), hash, deadline);
 }
 
-auto HashTable::FindNode(const std::string &key) -> Node * {
-  int h1 = Hash1(key);
-  int h2 = Hash2(key);
-  int i = 0;
-  while (arr_[h1] && i < capacity_) {
-    if (arr_[h1]->peer.key == key && arr_[h1]->state) {
-      return arr_[h1];
-    }
-    h1 = (h1 + h2) % capacity_;
-    ++i;
-  }
+auto HashTable::Get(const std::string &key) -> Peer * {
+  Tick();
+  RehashStep();
+  Position pos = LocateLive(key);
+  if (pos) return &pos.peer();
   return nullptr;
 }
 
 auto HashTable::Exists(const std::string &key) -> bool {
-  UpdateTimer();
-  return FindNode(key);
+  Tick();
+  RehashStep();
+  return static_cast<bool>(LocateLive(key));
 }
 
 auto HashTable::Del(const std::string &key) -> bool {
-  UpdateTimer();
-  Node *node = FindNode(key);
-  if (node && node->state) {
-    node->state = false;
-    ++deleted_;
-    --size_;
-    return true;
-  }
-  return false;
+  Tick();
+  RehashStep();
+  Position pos = LocateLive(key);
+  if (!pos) return false;
+  EraseAt(pos);
+  return true;
 }
 
 auto HashTable::Update(const std::string &key, const std::string &last_name,
                        const std::string &first_name, int year_of_birth,
                        const std::string &city, int number_of_current_coins)
     -> void {
-  UpdateTimer();
-  Node *node = FindNode(key);
-  if (node && node->state) {
-    if (!last_name.empty()) node->peer.last_name = last_name;
-    if (!first_name.empty()) node->peer.first_name = first_name;
-    if (year_of_birth) node->peer.year_of_birth = year_of_birth;
-    if (!city.empty()) node->peer.city = city;
+  Tick();
+  RehashStep();
+  Position pos = LocateLive(key);
+  if (pos) {
+    Peer &peer = pos.peer();
+    Untrack(peer);
+    if (!last_name.empty()) peer.last_name = last_name;
+    if (!first_name.empty()) peer.first_name = first_name;
+    if (year_of_birth) peer.year_of_birth = year_of_birth;
+    if (!city.empty()) peer.city = city;
     if (number_of_current_coins)
-      node->peer.number_of_current_coins = number_of_current_coins;
+      peer.number_of_current_coins = number_of_current_coins;
+    Track(peer);
   }
 }
 
 auto HashTable::Keys() -> std::vector<std::string> {
-  UpdateTimer();
-  std::vector<std::string> result;
-  result.reserve(size_);
-  for (int i = 0; i < capacity_; ++i) {
-    if (arr_[i] && arr_[i]->state) {
-      result.push_back(arr_[i]->peer.key);
-    }
-  }
-  return result;
+  Tick();
+  return Collect<std::string>([](Peer &peer, std::vector<std::string> *out) {
+    out->push_back(peer.key);
+  });
 }
 
+// Запись переносится в ячейку нового ключа перемещением, без копирования
+// значения; срок жизни и вторичные индексы переходят к новому ключу.
+// Живая запись с ключом key_new заменяется, как RENAME в Redis. Её
+// напоминание остаётся в колесе под key_new, но Reclaim удалит запись, только
+// если её срок совпадает со сроком напоминания; при совпадении он истекает и
+// у перенесённой записи, так что отменять напоминание не нужно.
 auto HashTable::Rename(const std::string &key_old, const std::string &key_new)
     -> void {
-  UpdateTimer();
-  Node *node = FindNode(key_old);
-  if (node) {
-    node->state = false;
-    node->peer.key = key_new;
-    Set(node->peer);
-  }
+  Tick();
+  RehashStep();
+  if (key_old == key_new) return;
+  uint64_t hash = HashKey(key_new);
+  Position target = LocateLive(key_new, hash);
+  Position pos = LocateLive(key_old);
+  if (!pos) return;
+  if (target) EraseAt(target);
+  Untrack(pos.peer());
+  Peer peer = std::move(pos.peer());
+  int64_t deadline = pos.slot().deadline;
+  pos.table->Erase(pos.index);
+  peer.key = key_new;
+  Track(peer);
+  InsertNew(std::move(peer), hash, deadline);
+  expiry_.Schedule(key_new, deadline);
 }
 
 auto HashTable::TTL(const std::string &key) -> int {
-  UpdateTimer();
-  auto itr = std::find_if(timer_.begin(), timer_.end(),
-                          [key](const std::pair<Node *, time_t> &a) {
-                            return key == a.first->peer.key;
-                          });
-  if (itr != timer_.end()) return (int)itr->second;
-  return 0;
+  Tick();
+  RehashStep();
+  Position pos = LocateLive(key);
+  if (!pos || !pos.slot().deadline) return 0;
+  return static_cast<int>(
+      (pos.slot().deadline - Expirer::NowMs() + 999) / 1000);
+}
+
+auto HashTable::Expire(const std::string &key, int seconds) -> bool {
+  return PExpireAt(key, Expirer::NowMs() + std::max(seconds, 0) * 1000LL);
+}
+
+auto HashTable::Persist(const std::string &key) -> bool {
+  Tick();
+  Position pos = LocateLive(key);
+  if (!pos || !pos.slot().deadline) return false;
+  SetDeadline(pos, 0);
+  return true;
+}
+
+auto HashTable::PTTL(const std::string &key) -> int64_t {
+  Tick();
+  RehashStep();
+  Position pos = LocateLive(key);
+  if (!pos) return -2;
+  if (!pos.slot().deadline) return -1;
+  return std::max<int64_t>(0, pos.slot().deadline - Expirer::NowMs());
+}
+
+auto HashTable::PExpireTime(const std::string &key) -> int64_t {
+  Tick();
+  RehashStep();
+  Position pos = LocateLive(key);
+  if (!pos) return -2;
+  return pos.slot().deadline ? pos.slot().deadline : -1;
+}
+
+auto HashTable::PExpireAt(const std::string &key, int64_t deadline) -> bool {
+  Tick();
+  Position pos = LocateLive(key);
+  if (!pos) return false;
+  if (Expirer::Expired(deadline, Expirer::NowMs())) {
+    EraseAt(pos);
+  } else {
+    SetDeadline(pos, deadline);
+  }
+  return true;
 }
 
 auto HashTable::Find(const std::string &last_name,
                      const std::string &first_name, int year_of_birth,
                      const std::string &city, int number_of_current_coins)
     -> std::vector<std::string> {
-  UpdateTimer();
+  Tick();
   std::vector<std::string> result;
-  for (int i = 0; i < capacity_; ++i) {
-    if (arr_[i] && arr_[i]->state &&
-        (last_name.empty() || arr_[i]->peer.last_name == last_name) &&
-        (first_name.empty() || arr_[i]->peer.first_name == first_name) &&
-        (!year_of_birth || arr_[i]->peer.year_of_birth == year_of_birth) &&
-        (city.empty() || arr_[i]->peer.city == city) &&
-        (number_of_current_coins == -1 ||
-         arr_[i]->peer.number_of_current_coins == number_of_current_coins)) {
-      result.push_back(arr_[i]->peer.key);
+  PeerFilter filter(last_name, first_name, year_of_birth, city,
+                    number_of_current_coins);
+  if (filter.Selective() && (indexing_ || columnar_)) {
+    auto candidates =
+        indexing_ ? index_.Find(filter) : columns_.Find(filter);
+    for (const std::string &key : candidates) {
+      if (LocateLive(key)) result.push_back(key);
     }
+    return result;
   }
-  return result;
+  if (filter.Impossible()) return result;
+  return Collect<std::string>(
+      [&filter](Peer &peer, std::vector<std::string> *out) {
+        if (filter(peer)) out->push_back(peer.key);
+      });
+}
+
+auto HashTable::SetColumnar(bool enable) -> bool {
+  columnar_ = enable;
+  columns_.Clear();
+  if (enable) ForEach([this](const Peer &peer) { columns_.Insert(peer); });
+  return true;
+}
+
+auto HashTable::Track(const Peer &peer) -> void {
+  if (indexing_) index_.Insert(peer);
+  if (columnar_) columns_.Insert(peer);
+}
+
+auto HashTable::Untrack(const Peer &peer) -> void {
+  if (indexing_) index_.Erase(peer);
+  if (columnar_) columns_.Erase(peer.key);
+}
+
+auto HashTable::SetIndexing(bool enable) -> bool {
+  indexing_ = enable;
+  index_.Clear();
+  if (enable) ForEach([this](const Peer &peer) { index_.Insert(peer); });
+  return true;
+}
+
+auto HashTable::SetParallelScan(size_t parts) -> bool {
+  scan_parts_ = parts ? parts : WorkerCount();
+  return true;
 }
 
 auto HashTable::ShowAll() -> std::vector<Peer *> {
-  UpdateTimer();
-  std::vector<Peer *> result;
-  result.reserve(size_);
-  for (int i = 0; i < capacity_; ++i) {
-    if (arr_[i] && arr_[i]->state) {
-      result.push_back(&arr_[i]->peer);
-    }
-  }
-  return result;
+  Tick();
+  return Collect<Peer *>(
+      [](Peer &peer, std::vector<Peer *> *out) { out->push_back(&peer); });
 }
 
 auto HashTable::Upload(const std::string &data_directory) -> int {
-  UpdateTimer();
-  std::ifstream file(data_directory);
-  int lines = 0;
-  if (file.is_open()) {
-    char c;
-    while ((c = file.get()) != EOF) {
-      if (c == '\n') ++lines;
-    }
-    Resize(2 * (capacity_ + lines));
-    file.clear();
-    file.seekg(0, std::ios_base::beg);
-    for (int i = 0; i < lines; ++i) {
-      Peer peer;
-      file >> peer.key;
-      file >> peer.last_name;
-      file >> peer.first_name;
-      file >> peer.year_of_birth;
-      file >> peer.city;
-      file >> peer.number_of_current_coins;
-      Set(peer);
-    }
-    file.close();
+  Tick();
+  auto batches = ParseRecords(data_directory);
+  int lines = RecordCount(batches);
+  Reserve(Size() + lines);
+  for (auto &batch : batches) {
+    for (Peer &peer : batch) Set(std::move(peer));
   }
   return lines;
 }
 
 auto HashTable::ExportData(const std::string &data_directory) -> int {
-  UpdateTimer();
+  Tick();
   std::ofstream file(data_directory);
+  int lines = 0;
   if (file.is_open()) {
-    for (int i = 0; i < capacity_; ++i) {
-      if (arr_[i] && arr_[i]->state) {
-        file << arr_[i]->peer.key << " ";
-        file << arr_[i]->peer.last_name << " ";
-        file << arr_[i]->peer.first_name << " ";
-        file << arr_[i]->peer.year_of_birth << " ";
-        file << arr_[i]->peer.city << " ";
-        file << arr_[i]->peer.number_of_current_coins << "\n";
-      }
-    }
+    ForEach([&file, &lines](const Peer &peer) {
+      file << peer.key << " ";
+      file << peer.last_name << " ";
+      file << peer.first_name << " ";
+      file << peer.year_of_birth << " ";
+      file << peer.city << " ";
+      file << peer.number_of_current_coins << "\n";
+      ++lines;
+    });
     file.close();
   }
-  return size_;
+  return lines;
+}
+
+auto HashTable::ActiveExpireCycle(std::chrono::microseconds budget) -> size_t {
+  return expiry_.Cycle(
+      [this](const std::string &key, int64_t deadline) {
+        return Reclaim(key, deadline);
+      },
+      budget);
 }
 
-auto HashTable::Horner(const std::string &key, int k) -> int {
-  int result = 0;
-  for (size_t i = 0; i < key.size(); ++i) {
-    result = (k * result + key[i]) % capacity_;
+auto HashTable::RehashStep(size_t groups) -> bool {
+  if (!Rehashing()) return false;
+  size_t total = old_table_.group_mask + 1;
+  for (; groups > 0 && migrate_group_ < total; --groups, ++migrate_group_) {
+    size_t base = migrate_group_ * kGroupWidth;
+    for (size_t i = base; i < base + kGroupWidth; ++i) {
+      if (old_table_.ctrl[i] < 0) continue;
+      Slot &slot = old_table_.slots[i];
+      table_.Insert(std::move(slot.peer), slot.hash, slot.deadline);
+      // Перенесённый слот помечается удалённым, а не пустым, чтобы не
+      // оборвать цепочки поиска ещё не перенесённых ключей.
+      old_table_.ctrl[i] = kDeleted;
+      --old_table_.size;
+    }
+  }
+  if (migrate_group_ == total) {
+    old_table_ = Table();
+    migrate_group_ = 0;
   }
-  result = (result * 2 + 1) % capacity_;
-  return std::abs(result);
+  return Rehashing();
 }
 
-auto HashTable::Hash1(const std::string &key) -> int {
-  return Horner(key, capacity_ - 1);
+HashTable::Table::Table(size_t min_capacity) {
+  capacity = kGroupWidth;
+  while (capacity < min_capacity) capacity <<= 1;
+  ctrl.assign(capacity, kEmpty);
+  slots.resize(capacity);
+  group_mask = capacity / kGroupWidth - 1;
 }
 
-auto HashTable::Hash2(const std::string &key) -> int {
-  return Horner(key, capacity_ + 1);
+// Группы перебираются треугольной последовательностью 0, 1, 3, 6, ... по
+// модулю степени двойки, которая обходит все группы таблицы.
+auto HashTable::Table::Find(std::string_view key, uint64_t hash) const
+    -> size_t {
+  if (size == 0) return kNpos;
+  size_t group = H1(hash) & group_mask;
+  for (size_t probe = 1; probe <= group_mask + 1; ++probe) {
+    size_t base = group * kGroupWidth;
+    Group g(&ctrl[base]);
+    for (uint32_t match = g.Match(H2(hash)); match; match &= match - 1) {
+      size_t index = base + LowestBit(match);
+      if (slots[index].hash == hash && slots[index].peer.key.Equals(key))
+        return index;
+    }
+    if (g.MatchEmpty()) break;
+    group = (group + probe) & group_mask;
+  }
+  return kNpos;
 }
 
-auto HashTable::ClearArr(const std::vector<Node *> &arr) -> void {
-  for (size_t i = 0; i < arr.size(); ++i) {
-    if (arr[i]) delete arr[i];
+auto HashTable::Table::FindInsertSlot(uint64_t hash) const -> size_t {
+  size_t group = H1(hash) & group_mask;
+  for (size_t probe = 1;; ++probe) {
+    size_t base = group * kGroupWidth;
+    uint32_t free = Group(&ctrl[base]).MatchEmptyOrDeleted();
+    if (free) return base + LowestBit(free);
+    group = (group + probe) & group_mask;
   }
 }
 
-auto HashTable::UpdateTimer() -> void {
-  auto start = std::chrono::system_clock::now();
-  auto iter = timer_.begin();
-  while (iter != timer_.end()) {
-    if (!(*iter).first ||
-        ((*iter).second -=
-         std::chrono::duration_cast<std::chrono::seconds>(start - old_time_)
-             .count()) <= 0) {
-      (*iter).first->state = false;
-      iter = timer_.erase(iter);
-    } else {
-      ++iter;
-    }
+auto HashTable::Table::Insert(Peer &&peer, uint64_t hash, int64_t deadline)
+    -> size_t {
+  size_t index = FindInsertSlot(hash);
+  if (ctrl[index] == kDeleted) --deleted;
+  ctrl[index] = H2(hash);
+  slots[index].peer = std::move(peer);
+  slots[index].hash = hash;
+  slots[index].deadline = deadline;
+  ++size;
+  return index;
+}
+
+auto HashTable::Table::Erase(size_t index) -> void {
+  size_t base = index & ~(kGroupWidth - 1);
+  // Если в группе уже есть пустой слот, ни один поиск не проходил через неё
+  // дальше, поэтому слот можно сразу сделать пустым, а не удалённым.
+  if (Group(&ctrl[base]).MatchEmpty()) {
+    ctrl[index] = kEmpty;
+  } else {
+    ctrl[index] = kDeleted;
+    ++deleted;
+  }
+  slots[index].peer = Peer{};
+  slots[index].deadline = 0;
+  --size;
+}
+
+auto HashTable::Locate(std::string_view key, uint64_t hash) -> Position {
+  size_t index = table_.Find(key, hash);
+  if (index != kNpos) return {&table_, index};
+  if (Rehashing()) {
+    index = old_table_.Find(key, hash);
+    if (index != kNpos) return {&old_table_, index};
   }
-  old_time_ = start;
+  return {nullptr, 0};
 }
 
-auto HashTable::Resize() -> void { Resize(2 * capacity_); }
+auto HashTable::LocateLive(std::string_view key, uint64_t hash)
+    -> Position {
+  Position pos = Locate(key, hash);
+  if (pos && Expirer::Expired(pos.slot().deadline, Expirer::NowMs())) {
+    EraseAt(pos);
+    return {nullptr, 0};
+  }
+  return pos;
+}
 
-auto HashTable::Resize(int size) -> void {
-  capacity_ = size;
-  size_ = 0;
-  deleted_ = 0;
-  std::vector<Node *> newArr(capacity_);
-  std::list<std::pair<Node *, time_t>> newList(std::move(timer_));
-  std::swap(arr_, newArr);
-  for (auto &iter : newList) {
-    if (iter.first && iter.first->state) {
-      Set(iter.first->peer, iter.second);
-    }
+auto HashTable::InsertNew(Peer &&peer, uint64_t hash, int64_t deadline)
+    -> void {
+  if (!table_.HasRoomFor(1)) {
+    // Новая таблица рассчитана так, чтобы перенос завершался раньше её
+    // заполнения; досрочное завершение здесь - лишь страховка.
+    FinishRehash();
+    if (!table_.HasRoomFor(1))
+      StartRehash(table_.deleted > table_.size ? table_.capacity
+                                               : 2 * table_.capacity);
   }
-  for (size_t i = 0; i < newArr.size(); ++i) {
-    if (newArr[i] && newArr[i]->state) Set(newArr[i]->peer);
+  table_.Insert(std::move(peer), hash, deadline);
+}
+
+auto HashTable::EraseAt(const Position &pos) -> void {
+  Untrack(pos.peer());
+  pos.table->Erase(pos.index);
+}
+
+auto HashTable::SetDeadline(const Position &pos, int64_t deadline) -> void {
+  pos.slot().deadline = deadline;
+  expiry_.Schedule(pos.peer().key, deadline);
+}
+
+auto HashTable::StartRehash(size_t capacity) -> void {
+  FinishRehash();
+  old_table_ = std::move(table_);
+  table_ = Table(capacity);
+  migrate_group_ = 0;
+  RehashStep();
+}
+
+auto HashTable::FinishRehash() -> void {
+  while (RehashStep(old_table_.group_mask + 1)) {
+  }
+}
+
+auto HashTable::Reserve(size_t count) -> void {
+  if (table_.capacity * 7 >= count * 8) return;
+  size_t capacity = table_.capacity;
+  while (capacity * 7 < count * 8) capacity <<= 1;
+  if (Size() == 0) {
+    FinishRehash();
+    table_ = Table(capacity);
+  } else {
+    StartRehash(capacity);
   }
-  ClearArr(newArr);
 }
+
+// Обходит живые записи обеих таблиц; истёкшие, но ещё не удалённые записи
+// пропускаются.
+template <typename Func>
+auto HashTable::ForEach(Func func) -> void {
+  ForEachInPart(0, 1, func);
+}
+
+// Часть part из parts: одинаковая доля слотов каждой из таблиц.
+template <typename Func>
+auto HashTable::ForEachInPart(size_t part, size_t parts, Func func) -> void {
+  int64_t now = Expirer::NowMs();
+  for (Table *table : {&table_, &old_table_}) {
+    size_t end = table->capacity * (part + 1) / parts;
+    for (size_t i = table->capacity * part / parts; i < end; ++i) {
+      if (table->ctrl[i] >= 0 &&
+          !Expirer::Expired(table->slots[i].deadline, now))
+        func(table->slots[i].peer);
+    }
+  }
+}
+
+// Полный обход, разделённый на части в WorkerPool: func(peer, &out)
+// добавляет результаты записи в вектор своей части.
+template <typename T, typename Func>
+auto HashTable::Collect(Func func) -> std::vector<T> {
+  size_t parts = std::clamp<size_t>(Size() / kMinScanPart, 1, scan_parts_);
+  return WorkerPool::Instance().Gather<T>(
+      parts, [this, parts, &func](size_t part, std::vector<T> *out) {
+        ForEachInPart(part, parts,
+                      [out, &func](Peer &peer) { func(peer, out); });
+      });
+}
+
+auto HashTable::Reclaim(const std::string &key, int64_t deadline) -> bool {
+  Position pos = Locate(key);
+  if (!pos || pos.slot().deadline != deadline) return false;
+  EraseAt(pos);
+  return true;
+}
+
+auto HashTable::Tick() -> void {
+  expiry_.Tick([this](const std::string &key, int64_t deadline) {
+    return Reclaim(key, deadline);
+  });
+}
+
 }  // namespace s21
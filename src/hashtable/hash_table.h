@@ -1,18 +1,21 @@
 #ifndef A6_HASH_TABLE_H
 #define A6_HASH_TABLE_H
 
-#include <chrono>
 #include <fstream>
 #include <iostream>
-#include <list>
 
+#include "../expiration/expirer.h"
+#include "../index/column_store.h"
+#include "../index/secondary_index.h"
+#include "../other/hash.h"
 #include "../other/key_value.h"
+#include "../other/worker_pool.h"
 
 namespace s21 {
 class HashTable : public KeyValue {
  public:
-  HashTable() : arr_(kStartSize) {}
-  ~HashTable() override { ClearArr(arr_); }
+  HashTable() = default;
+  ~HashTable() override = default;
 
   /// @brief Команда используется для установки ключа и его значения.
   /// @param key
@@ -22,9 +25,12 @@ class HashTable : public KeyValue {
   /// @param city
   /// @param number_of_current_coins
   /// @param time_of_life
-  auto Set(const Peer &peer, int time_of_life = 0) -> void override;
+  auto Set(Peer peer, int time_of_life = 0) -> void override;
 
   /// @brief Команда используется для получения значения, связанного с ключом.
+  /// Указатель ведёт в слот таблицы и действителен до следующего обращения к
+  /// хранилищу: любая операция может перенести запись шагом перехеширования
+  /// или удалить истёкшие записи.
   /// @param key
   /// @return Если такой записи нет, то будет возвращён (null):
   auto Get(const std::string &key) -> Peer * override;
@@ -70,6 +76,33 @@ class HashTable : public KeyValue {
   /// @return Если записи с заданным ключом не существует, то возвращается 0
   auto TTL(const std::string &key) -> int override;
 
+  /// @brief Устанавливает время жизни существующего ключа, не меняя значения.
+  /// @param key
+  /// @param seconds если не больше 0, ключ удаляется сразу
+  /// @return Возвращает false, если ключа нет
+  auto Expire(const std::string &key, int seconds) -> bool override;
+
+  /// @brief Снимает ограничение времени жизни ключа.
+  /// @param key
+  /// @return Возвращает true, если у ключа было время жизни
+  auto Persist(const std::string &key) -> bool override;
+
+  /// @brief Оставшееся время жизни ключа в миллисекундах.
+  /// @param key
+  /// @return -2, если ключа нет, и -1, если время жизни не ограничено
+  auto PTTL(const std::string &key) -> int64_t override;
+
+  /// @brief Срок истечения ключа в миллисекундах по часам Expirer::NowMs.
+  /// @param key
+  /// @return -2, если ключа нет, и -1, если время жизни не ограничено
+  auto PExpireTime(const std::string &key) -> int64_t override;
+
+  /// @brief Устанавливает абсолютный срок истечения существующего ключа.
+  /// @param key
+  /// @param deadline 0 - без ограничения; наступивший срок удаляет ключ
+  /// @return Возвращает false, если ключа нет
+  auto PExpireAt(const std::string &key, int64_t deadline) -> bool override;
+
   /// @brief Эта команда используется для восстановления ключа (или ключей) по
   /// заданному значению.
   /// @param last_name
@@ -83,11 +116,37 @@ class HashTable : public KeyValue {
             const std::string &city = "", int number_of_current_coins = -1)
       -> std::vector<std::string> override;
 
+  /// @brief Включает или выключает вторичные индексы по полям значения,
+  /// ускоряющие Find. При включении индексы строятся по текущим данным.
+  /// @param enable
+  /// @return true
+  auto SetIndexing(bool enable) -> bool override;
+
+  /// @brief Включает или выключает колоночную копию полей значения, по
+  /// которой Find без индексов выполняется векторным сканированием.
+  /// @param enable
+  /// @return true
+  auto SetColumnar(bool enable) -> bool override;
+
+  /// @brief Полный обход делится на равные диапазоны слотов обеих таблиц.
+  /// @param parts
+  /// @return true
+  auto SetParallelScan(size_t parts) -> bool override;
+
   /// @brief Команда для получения всех записей, которые содержатся в key-value
-  /// хранилище на текущий момент
+  /// хранилище на текущий момент. Указатели действительны до следующего
+  /// обращения к хранилищу, как и у Get.
   /// @return
   auto ShowAll() -> std::vector<Peer *> override;
 
+  /// @brief Цикл активного удаления истёкших ключей. Хранилище запускает его
+  /// само по ходу операций, но его можно вызывать и в периоды простоя.
+  /// @param budget ограничение времени работы цикла
+  /// @return Число удалённых записей
+  auto ActiveExpireCycle(
+      std::chrono::microseconds budget = std::chrono::milliseconds(1))
+      -> size_t override;
+
   /// @brief Данная команда используется для загрузки данных из файла.
   /// @param data_directory
   /// @return Выводится число загруженных строк из файла.
@@ -99,33 +158,114 @@ class HashTable : public KeyValue {
   /// @return Число выгруженных строк из файла.
   auto ExportData(const std::string &data_directory) -> int override;
 
+  /// @brief Шаг постепенного перехеширования: переносит не более groups групп
+  /// слотов из старой таблицы в новую. Его выполняют и изменяющие операции, и
+  /// поиск по ключу, поэтому перенос завершается и при нагрузке из одних
+  /// чтений. Может вызываться в периоды простоя.
+  /// @param groups
+  /// @return true, если перенос ещё не завершён
+  auto RehashStep(size_t groups = kRehashGroups) -> bool;
+
  public:
-  const int kStartSize = 8;
-  const double kResizeCoef = 0.5;
+  static constexpr size_t kGroupWidth = 16;
+  static constexpr size_t kStartSize = 2 * kGroupWidth;
+  static constexpr size_t kRehashGroups = 2;
+
+ private:
+  static constexpr size_t kNpos = static_cast<size_t>(-1);
+  /// Меньше записей на часть обход не делит: запуск части дороже.
+  static constexpr size_t kMinScanPart = 1 << 14;
 
-  struct Node {
+  /// Управляющий байт слота: отрицательные значения - пустой или удалённый
+  /// слот, неотрицательные - занятый слот с младшими 7 битами хеша ключа.
+  enum Ctrl : int8_t { kEmpty = -128, kDeleted = -2 };
+
+  /// Запись вместе с хешем ключа и абсолютным сроком истечения (0 - без
+  /// срока): при расширении таблицы ключи повторно не хешируются.
+  struct Slot {
     Peer peer;
-    bool state;
+    uint64_t hash{0};
+    int64_t deadline{0};
+  };
+
+  /// Массив слотов с управляющими байтами. Во время перехеширования живут
+  /// две таблицы: новые записи попадают в table_, а old_table_ постепенно
+  /// переносится в неё.
+  struct Table {
+    std::vector<int8_t> ctrl;
+    std::vector<Slot> slots;
+    size_t capacity = 0;
+    size_t group_mask = 0;
+    size_t size = 0;
+    size_t deleted = 0;
 
-    explicit Node(const Peer &peer) : peer(peer), state(true) {}
+    Table() = default;
+    explicit Table(size_t min_capacity);
+
+    auto Find(std::string_view key, uint64_t hash) const -> size_t;
+    auto FindInsertSlot(uint64_t hash) const -> size_t;
+    auto Insert(Peer &&peer, uint64_t hash, int64_t deadline) -> size_t;
+    auto Erase(size_t index) -> void;
+    auto HasRoomFor(size_t count) const -> bool {
+      return (size + deleted + count) * 8 <= capacity * 7;
+    }
+  };
+
+  struct Position {
+    Table *table;
+    size_t index;
+
+    explicit operator bool() const { return table != nullptr; }
+    auto slot() const -> Slot & { return table->slots[index]; }
+    auto peer() const -> Peer & { return slot().peer; }
   };
 
-  auto Horner(const std::string &key, int k) -> int;
-  auto Hash1(const std::string &key) -> int;
-  auto Hash2(const std::string &key) -> int;
-  auto Resize() -> void;
-  auto Resize(int size) -> void;
-  auto Rehash() -> void;
-  auto ClearArr(const std::vector<Node *> &arr) -> void;
-  auto FindNode(const std::string &key) -> Node *;
-  auto UpdateTimer() -> void;
-
-  std::vector<Node *> arr_;
-  std::list<std::pair<Node *, time_t>> timer_;
-  std::chrono::system_clock::time_point old_time_;
-  int size_ = 0;
-  int deleted_ = 0;
-  int capacity_ = kStartSize;
+  static auto HashKey(std::string_view key) -> uint64_t {
+    return HashBytes(key);
+  }
+  static auto H1(uint64_t hash) -> size_t {
+    return static_cast<size_t>(hash >> 7);
+  }
+  static auto H2(uint64_t hash) -> int8_t {
+    return static_cast<int8_t>(hash & 0x7F);
+  }
+
+  auto Locate(std::string_view key) -> Position {
+    return Locate(key, HashKey(key));
+  }
+  auto Locate(std::string_view key, uint64_t hash) -> Position;
+  auto LocateLive(std::string_view key) -> Position {
+    return LocateLive(key, HashKey(key));
+  }
+  auto LocateLive(std::string_view key, uint64_t hash) -> Position;
+  auto Rehashing() const -> bool { return old_table_.capacity != 0; }
+  auto Size() const -> size_t { return table_.size + old_table_.size; }
+  auto InsertNew(Peer &&peer, uint64_t hash, int64_t deadline) -> void;
+  auto EraseAt(const Position &pos) -> void;
+  auto Track(const Peer &peer) -> void;
+  auto Untrack(const Peer &peer) -> void;
+  auto SetDeadline(const Position &pos, int64_t deadline) -> void;
+  auto StartRehash(size_t capacity) -> void;
+  auto FinishRehash() -> void;
+  auto Reserve(size_t count) -> void;
+  template <typename Func>
+  auto ForEach(Func func) -> void;
+  template <typename Func>
+  auto ForEachInPart(size_t part, size_t parts, Func func) -> void;
+  template <typename T, typename Func>
+  auto Collect(Func func) -> std::vector<T>;
+  auto Reclaim(const std::string &key, int64_t deadline) -> bool;
+  auto Tick() -> void;
+
+  Table table_{kStartSize};
+  Table old_table_;
+  size_t migrate_group_ = 0;
+  Expirer expiry_;
+  SecondaryIndex index_;
+  ColumnStore columns_;
+  bool indexing_ = false;
+  bool columnar_ = false;
+  size_t scan_parts_ = WorkerCount();
 };
 
 }  // namespace s21
@@ -0,0 +1,139 @@
+#include "column_store.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define A6_COLUMN_STORE_AVX2
+#endif
+
+namespace s21 {
+
+namespace {
+
+// Оставляет в bits только строки, у которых lo <= column[i] <= hi.
+void FilterScalar(const int32_t *column, size_t begin, size_t n, int32_t lo,
+                  int32_t hi, uint64_t *bits) {
+  for (size_t i = begin; i < n; ++i) {
+    if (column[i] < lo || column[i] > hi)
+      bits[i / 64] &= ~(uint64_t{1} << (i % 64));
+  }
+}
+
+#ifdef A6_COLUMN_STORE_AVX2
+__attribute__((target("avx2"))) void FilterAvx2(const int32_t *column,
+                                                size_t n, int32_t lo,
+                                                int32_t hi, uint64_t *bits) {
+  const __m256i vlo = _mm256_set1_epi32(lo);
+  const __m256i vhi = _mm256_set1_epi32(hi);
+  size_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    uint64_t word = 0;
+    for (unsigned j = 0; j < 8; ++j) {
+      __m256i v = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(column + i + j * 8));
+      __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(vlo, v),
+                                    _mm256_cmpgt_epi32(v, vhi));
+      auto miss = static_cast<uint32_t>(
+          _mm256_movemask_ps(_mm256_castsi256_ps(out)));
+      word |= static_cast<uint64_t>(~miss & 0xFFu) << (j * 8);
+    }
+    bits[i / 64] &= word;
+  }
+  FilterScalar(column, i, n, lo, hi, bits);
+}
+
+auto HasAvx2() -> bool {
+  static const bool has = __builtin_cpu_supports("avx2");
+  return has;
+}
+#endif
+
+void Filter(const int32_t *column, size_t n, int32_t lo, int32_t hi,
+            uint64_t *bits) {
+#ifdef A6_COLUMN_STORE_AVX2
+  if (HasAvx2()) return FilterAvx2(column, n, lo, hi, bits);
+#endif
+  FilterScalar(column, 0, n, lo, hi, bits);
+}
+
+}  // namespace
+
+auto ColumnStore::Insert(const Peer &peer) -> void {
+  auto row = static_cast<uint32_t>(keys_.size());
+  if (!rows_.emplace(peer.key, row).second) return;
+  keys_.push_back(peer.key);
+  Column(Field::kLastName).push_back(static_cast<int32_t>(peer.last_name.Id()));
+  Column(Field::kFirstName)
+      .push_back(static_cast<int32_t>(peer.first_name.Id()));
+  Column(Field::kYearOfBirth).push_back(peer.year_of_birth);
+  Column(Field::kCity).push_back(static_cast<int32_t>(peer.city.Id()));
+  Column(Field::kCoins).push_back(peer.number_of_current_coins);
+}
+
+// Строка удаляется перестановкой последней строки на её место.
+auto ColumnStore::Erase(const std::string &key) -> void {
+  auto found = rows_.find(key);
+  if (found == rows_.end()) return;
+  uint32_t row = found->second;
+  rows_.erase(found);
+  size_t last = keys_.size() - 1;
+  if (row != last) {
+    for (auto &column : columns_) column[row] = column[last];
+    keys_[row] = std::move(keys_[last]);
+    rows_[keys_[row]] = row;
+  }
+  for (auto &column : columns_) column.pop_back();
+  keys_.pop_back();
+}
+
+auto ColumnStore::Clear() -> void {
+  for (auto &column : columns_) column.clear();
+  keys_.clear();
+  rows_.clear();
+}
+
+auto ColumnStore::Encode(const std::string &value) -> int32_t {
+  InternedString interned;
+  if (!InternedString::Lookup(value, &interned)) return -1;
+  return static_cast<int32_t>(interned.Id());
+}
+
+auto ColumnStore::Select(const std::vector<Predicate> &predicates) const
+    -> std::vector<std::string> {
+  size_t n = keys_.size();
+  std::vector<uint64_t> bits((n + 63) / 64, ~uint64_t{0});
+  if (n % 64) bits.back() = (uint64_t{1} << (n % 64)) - 1;
+  for (const Predicate &predicate : predicates) {
+    if (predicate.lo > predicate.hi) return {};
+    Filter(Column(predicate.field).data(), n, predicate.lo, predicate.hi,
+           bits.data());
+  }
+  std::vector<std::string> result;
+  for (size_t word = 0; word < bits.size(); ++word) {
+    for (uint64_t w = bits[word]; w; w &= w - 1)
+      result.push_back(keys_[word * 64 + __builtin_ctzll(w)]);
+  }
+  return result;
+}
+
+auto ColumnStore::Find(const PeerFilter &filter) const
+    -> std::vector<std::string> {
+  if (filter.Impossible()) return {};
+  std::vector<Predicate> predicates;
+  auto add_string = [&predicates](Field field, const InternedString &v) {
+    auto id = static_cast<int32_t>(v.Id());
+    predicates.push_back({field, id, id});
+  };
+  if (!filter.LastName().Empty())
+    add_string(Field::kLastName, filter.LastName());
+  if (!filter.FirstName().Empty())
+    add_string(Field::kFirstName, filter.FirstName());
+  if (filter.YearOfBirth())
+    predicates.push_back(
+        {Field::kYearOfBirth, filter.YearOfBirth(), filter.YearOfBirth()});
+  if (!filter.City().Empty()) add_string(Field::kCity, filter.City());
+  if (filter.Coins() != -1)
+    predicates.push_back({Field::kCoins, filter.Coins(), filter.Coins()});
+  return Select(predicates);
+}
+
+}  // namespace s21
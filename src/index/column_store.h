@@ -0,0 +1,71 @@
+#ifndef A6_COLUMN_STORE_H
+#define A6_COLUMN_STORE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../other/key_value.h"
+#include "peer_filter.h"
+
+namespace s21 {
+
+/// @brief Теневое колоночное хранилище полей Peer для Find без индексов и
+/// произвольных фильтров. Все поля лежат в плотных массивах int32:
+/// строковые поля хранятся номерами из общего словаря строк. Условия проверяются
+/// векторными сравнениями (AVX2, если процессор его поддерживает) и
+/// накапливаются в битовой маске строк; ключи читаются только для
+/// подошедших строк.
+class ColumnStore {
+ public:
+  enum class Field : unsigned {
+    kLastName,
+    kFirstName,
+    kYearOfBirth,
+    kCity,
+    kCoins,
+  };
+
+  /// Условие lo <= поле <= hi; для строковых полей lo == hi == Encode(...).
+  struct Predicate {
+    Field field;
+    int32_t lo;
+    int32_t hi;
+  };
+
+  auto Insert(const Peer &peer) -> void;
+  auto Erase(const std::string &key) -> void;
+  auto Clear() -> void;
+  auto Size() const -> size_t { return keys_.size(); }
+
+  /// @brief Номер строкового значения в словаре или -1, если такого
+  /// значения нет ни в одной записи.
+  static auto Encode(const std::string &value) -> int32_t;
+
+  /// @brief Ключи строк, удовлетворяющих всем условиям.
+  auto Select(const std::vector<Predicate> &predicates) const
+      -> std::vector<std::string>;
+
+  /// @brief То же, что Select, с условиями запроса Find.
+  auto Find(const PeerFilter &filter) const -> std::vector<std::string>;
+
+ private:
+  static constexpr size_t kFields = 5;
+
+  auto Column(Field field) const -> const std::vector<int32_t> & {
+    return columns_[static_cast<unsigned>(field)];
+  }
+  auto Column(Field field) -> std::vector<int32_t> & {
+    return columns_[static_cast<unsigned>(field)];
+  }
+
+  std::array<std::vector<int32_t>, kFields> columns_;
+  std::vector<std::string> keys_;
+  std::unordered_map<std::string, uint32_t> rows_;
+};
+
+}  // namespace s21
+
+#endif  // A6_COLUMN_STORE_H
@@ -0,0 +1,64 @@
+#ifndef A6_PEER_FILTER_H
+#define A6_PEER_FILTER_H
+
+#include <string>
+
+#include "../other/key_value.h"
+
+namespace s21 {
+
+/// @brief Условия запроса Find, один раз переведённые в номера словаря
+/// строк: проверка записи сводится к сравнению целых чисел. Пустая строка,
+/// нулевой год и -1 монет означают отсутствие условия.
+class PeerFilter {
+ public:
+  PeerFilter(const std::string &last_name, const std::string &first_name,
+             int year_of_birth, const std::string &city,
+             int number_of_current_coins)
+      : year_of_birth_(year_of_birth), coins_(number_of_current_coins) {
+    Resolve(last_name, &last_name_);
+    Resolve(first_name, &first_name_);
+    Resolve(city, &city_);
+  }
+
+  /// @brief Есть ли хотя бы одно условие.
+  auto Selective() const -> bool {
+    return !last_name_.Empty() || !first_name_.Empty() || year_of_birth_ ||
+           !city_.Empty() || coins_ != -1 || impossible_;
+  }
+
+  /// @brief Одна из строк запроса не встречается ни в одной записи.
+  auto Impossible() const -> bool { return impossible_; }
+
+  auto operator()(const Peer &peer) const -> bool {
+    return !impossible_ &&
+           (last_name_.Empty() || peer.last_name == last_name_) &&
+           (first_name_.Empty() || peer.first_name == first_name_) &&
+           (!year_of_birth_ || peer.year_of_birth == year_of_birth_) &&
+           (city_.Empty() || peer.city == city_) &&
+           (coins_ == -1 || peer.number_of_current_coins == coins_);
+  }
+
+  auto LastName() const -> const InternedString & { return last_name_; }
+  auto FirstName() const -> const InternedString & { return first_name_; }
+  auto YearOfBirth() const -> int { return year_of_birth_; }
+  auto City() const -> const InternedString & { return city_; }
+  auto Coins() const -> int { return coins_; }
+
+ private:
+  auto Resolve(const std::string &value, InternedString *out) -> void {
+    if (!value.empty() && !InternedString::Lookup(value, out))
+      impossible_ = true;
+  }
+
+  InternedString last_name_;
+  InternedString first_name_;
+  int year_of_birth_;
+  InternedString city_;
+  int coins_;
+  bool impossible_{false};
+};
+
+}  // namespace s21
+
+#endif  // A6_PEER_FILTER_H
@@ -0,0 +1,79 @@
+#include "secondary_index.h"
+
+#include <algorithm>
+
+namespace s21 {
+
+auto SecondaryIndex::Insert(const Peer &peer) -> void {
+  Add(last_name_, peer.last_name.Id(), peer.key);
+  Add(first_name_, peer.first_name.Id(), peer.key);
+  Add(year_of_birth_, peer.year_of_birth, peer.key);
+  Add(city_, peer.city.Id(), peer.key);
+  Add(coins_, peer.number_of_current_coins, peer.key);
+}
+
+auto SecondaryIndex::Erase(const Peer &peer) -> void {
+  Remove(last_name_, peer.last_name.Id(), peer.key);
+  Remove(first_name_, peer.first_name.Id(), peer.key);
+  Remove(year_of_birth_, peer.year_of_birth, peer.key);
+  Remove(city_, peer.city.Id(), peer.key);
+  Remove(coins_, peer.number_of_current_coins, peer.key);
+}
+
+auto SecondaryIndex::Clear() -> void {
+  last_name_.clear();
+  first_name_.clear();
+  year_of_birth_.clear();
+  city_.clear();
+  coins_.clear();
+}
+
+auto SecondaryIndex::Find(const PeerFilter &filter) const
+    -> std::vector<std::string> {
+  static const Posting kNothing;
+  std::vector<std::string> result;
+  if (filter.Impossible()) return result;
+  std::vector<const Posting *> postings;
+  if (!filter.LastName().Empty())
+    postings.push_back(Lookup(last_name_, filter.LastName().Id()));
+  if (!filter.FirstName().Empty())
+    postings.push_back(Lookup(first_name_, filter.FirstName().Id()));
+  if (filter.YearOfBirth())
+    postings.push_back(Lookup(year_of_birth_, filter.YearOfBirth()));
+  if (!filter.City().Empty())
+    postings.push_back(Lookup(city_, filter.City().Id()));
+  if (filter.Coins() != -1)
+    postings.push_back(Lookup(coins_, filter.Coins()));
+  if (postings.empty()) return result;
+  for (auto &posting : postings)
+    if (!posting) posting = &kNothing;
+  std::sort(postings.begin(), postings.end(),
+            [](const Posting *a, const Posting *b) {
+              return a->size() < b->size();
+            });
+  for (const std::string &key : *postings.front()) {
+    bool all = std::all_of(
+        postings.begin() + 1, postings.end(),
+        [&key](const Posting *posting) { return posting->count(key) != 0; });
+    if (all) result.push_back(key);
+  }
+  return result;
+}
+
+template <typename V>
+auto SecondaryIndex::Remove(Column<V> &column, const V &value,
+                            const std::string &key) -> void {
+  auto found = column.find(value);
+  if (found == column.end()) return;
+  found->second.erase(key);
+  if (found->second.empty()) column.erase(found);
+}
+
+template <typename V>
+auto SecondaryIndex::Lookup(const Column<V> &column, const V &value)
+    -> const Posting * {
+  auto found = column.find(value);
+  return found == column.end() ? nullptr : &found->second;
+}
+
+}  // namespace s21
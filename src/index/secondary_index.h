@@ -0,0 +1,57 @@
+#ifndef A6_SECONDARY_INDEX_H
+#define A6_SECONDARY_INDEX_H
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../other/key_value.h"
+#include "peer_filter.h"
+
+namespace s21 {
+
+/// @brief Вторичные индексы по равенству для полей Peer. Для каждого
+/// значения поля хранится список ключей (posting list). Запрос Find по
+/// нескольким полям отвечается пересечением списков, начиная с самого
+/// короткого. Строковые поля индексируются номерами из словаря строк.
+class SecondaryIndex {
+ public:
+  using Posting = std::unordered_set<std::string>;
+
+  auto Insert(const Peer &peer) -> void;
+  auto Erase(const Peer &peer) -> void;
+  auto Clear() -> void;
+
+  /// @brief Ключи записей, удовлетворяющих всем условиям запроса.
+  /// @return Порядок ключей не определён
+  auto Find(const PeerFilter &filter) const -> std::vector<std::string>;
+
+ private:
+  template <typename V>
+  using Column = std::unordered_map<V, Posting>;
+
+  template <typename V>
+  static auto Add(Column<V> &column, const V &value, const std::string &key)
+      -> void {
+    column[value].insert(key);
+  }
+
+  template <typename V>
+  static auto Remove(Column<V> &column, const V &value, const std::string &key)
+      -> void;
+
+  template <typename V>
+  static auto Lookup(const Column<V> &column, const V &value)
+      -> const Posting *;
+
+  Column<uint32_t> last_name_;
+  Column<uint32_t> first_name_;
+  Column<int> year_of_birth_;
+  Column<uint32_t> city_;
+  Column<int> coins_;
+};
+
+}  // namespace s21
+
+#endif  // A6_SECONDARY_INDEX_H
@@ -0,0 +1,235 @@
+#ifndef A6_COMPACT_KEY_H
+#define A6_COMPACT_KEY_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "hash.h"
+
+/// Сколько байт ключа хранится прямо в записи. Длинные ключи уходят в
+/// общую арену.
+#ifndef A6_KEY_INLINE
+#define A6_KEY_INLINE 23
+#endif
+
+namespace s21 {
+
+/// @brief Арена для длинных ключей CompactKey. Память выделяется из
+/// крупных блоков классами по 16 байт; освобождённые куски возвращаются в
+/// список своего класса и переиспользуются. Куски больше kMaxClassed
+/// берутся у operator new напрямую.
+class KeyArena {
+ public:
+  static auto Instance() -> KeyArena & {
+    static KeyArena arena;
+    return arena;
+  }
+
+  KeyArena(const KeyArena &) = delete;
+  auto operator=(const KeyArena &) -> KeyArena & = delete;
+
+  ~KeyArena() {
+    for (char *block : blocks_) ::operator delete(block);
+  }
+
+  auto Allocate(size_t size) -> char * {
+    if (size > kMaxClassed) return static_cast<char *>(::operator new(size));
+    size_t cls = Class(size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (FreeChunk *chunk = free_[cls]) {
+      free_[cls] = chunk->next;
+      return reinterpret_cast<char *>(chunk);
+    }
+    size_t bytes = (cls + 1) * kGranule;
+    if (left_ < bytes) {
+      blocks_.push_back(static_cast<char *>(::operator new(kBlockSize)));
+      cursor_ = blocks_.back();
+      left_ = kBlockSize;
+    }
+    char *result = cursor_;
+    cursor_ += bytes;
+    left_ -= bytes;
+    return result;
+  }
+
+  auto Free(char *data, size_t size) -> void {
+    if (size > kMaxClassed) return ::operator delete(data);
+    size_t cls = Class(size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto *chunk = reinterpret_cast<FreeChunk *>(data);
+    chunk->next = free_[cls];
+    free_[cls] = chunk;
+  }
+
+ private:
+  static constexpr size_t kGranule = 16;
+  static constexpr size_t kMaxClassed = 512;
+  static constexpr size_t kBlockSize = 64 * 1024;
+
+  struct FreeChunk {
+    FreeChunk *next;
+  };
+
+  KeyArena() = default;
+
+  static auto Class(size_t size) -> size_t {
+    return (size + kGranule - 1) / kGranule - 1;
+  }
+
+  std::array<FreeChunk *, kMaxClassed / kGranule> free_{};
+  std::vector<char *> blocks_;
+  char *cursor_{nullptr};
+  size_t left_{0};
+  std::mutex mutex_;
+};
+
+/// @brief Ключ записи без отдельного выделения памяти для коротких строк.
+/// Рядом с байтами лежат длина и 32-битный префикс хеша, поэтому неравные
+/// ключи обычно различаются сравнением одного машинного слова. Ключи
+/// длиннее kInline байт хранятся в KeyArena. Неявно приводится к
+/// std::string и создаётся из него.
+class CompactKey {
+ public:
+  static constexpr size_t kInline = A6_KEY_INLINE;
+  static_assert(kInline + 1 >= sizeof(char *),
+                "A6_KEY_INLINE must fit a pointer");
+
+  CompactKey() { inline_[0] = '\0'; }
+  CompactKey(const std::string &key) { Assign(key.data(), key.size()); }
+  CompactKey(const char *key) { Assign(key, std::strlen(key)); }
+
+  CompactKey(const CompactKey &other) {
+    AssignWithHash(other.Data(), other.size_, other.hash_);
+  }
+
+  CompactKey(CompactKey &&other) noexcept { Steal(other); }
+
+  auto operator=(const CompactKey &other) -> CompactKey & {
+    if (this != &other) {
+      Release();
+      AssignWithHash(other.Data(), other.size_, other.hash_);
+    }
+    return *this;
+  }
+
+  auto operator=(CompactKey &&other) noexcept -> CompactKey & {
+    if (this != &other) {
+      Release();
+      Steal(other);
+    }
+    return *this;
+  }
+
+  ~CompactKey() { Release(); }
+
+  operator std::string() const { return std::string(Data(), size_); }
+
+  auto Data() const -> const char * {
+    return size_ <= kInline ? inline_ : external_;
+  }
+  auto Size() const -> size_t { return size_; }
+  auto View() const -> std::string_view { return {Data(), size_}; }
+  auto Inline() const -> bool { return size_ <= kInline; }
+
+  auto Equals(std::string_view other) const -> bool {
+    return size_ == other.size() &&
+           std::memcmp(Data(), other.data(), size_) == 0;
+  }
+
+  /// @brief Лексикографическое сравнение, как у std::string::compare.
+  auto Compare(std::string_view other) const -> int {
+    size_t n = size_ < other.size() ? size_ : other.size();
+    int result = n ? std::memcmp(Data(), other.data(), n) : 0;
+    if (result) return result;
+    return size_ < other.size() ? -1 : size_ > other.size() ? 1 : 0;
+  }
+
+  friend auto operator==(const CompactKey &a, const CompactKey &b) -> bool {
+    return a.hash_ == b.hash_ && a.size_ == b.size_ &&
+           std::memcmp(a.Data(), b.Data(), a.size_) == 0;
+  }
+  friend auto operator==(const CompactKey &a, const std::string &b) -> bool {
+    return a.Equals(b);
+  }
+  friend auto operator==(const std::string &a, const CompactKey &b) -> bool {
+    return b.Equals(a);
+  }
+  friend auto operator==(const CompactKey &a, const char *b) -> bool {
+    return a.Equals(b);
+  }
+  friend auto operator!=(const CompactKey &a, const CompactKey &b) -> bool {
+    return !(a == b);
+  }
+  friend auto operator!=(const CompactKey &a, const std::string &b) -> bool {
+    return !a.Equals(b);
+  }
+  friend auto operator!=(const CompactKey &a, const char *b) -> bool {
+    return !a.Equals(b);
+  }
+  friend auto operator<(const CompactKey &a, const CompactKey &b) -> bool {
+    return a.Compare(b.View()) < 0;
+  }
+  friend auto operator>(const CompactKey &a, const CompactKey &b) -> bool {
+    return a.Compare(b.View()) > 0;
+  }
+  friend auto operator<<(std::ostream &out, const CompactKey &key)
+      -> std::ostream & {
+    return out.write(key.Data(), static_cast<std::streamsize>(key.size_));
+  }
+  friend auto operator>>(std::istream &in, CompactKey &key) -> std::istream & {
+    std::string word;
+    if (in >> word) key = word;
+    return in;
+  }
+
+ private:
+  // Единственное место, где ключ хешируется: копии берут готовый хеш.
+  auto Assign(const char *data, size_t size) -> void {
+    uint64_t hash = HashBytes(data, size, HashSeed());
+    AssignWithHash(data, size, static_cast<uint32_t>(hash >> 32));
+  }
+
+  auto AssignWithHash(const char *data, size_t size, uint32_t hash) -> void {
+    size_ = static_cast<uint32_t>(size);
+    hash_ = hash;
+    char *target = inline_;
+    if (size > kInline) target = external_ = KeyArena::Instance().Allocate(size);
+    std::memcpy(target, data, size);
+  }
+
+  auto Steal(CompactKey &other) -> void {
+    hash_ = other.hash_;
+    size_ = other.size_;
+    std::memcpy(inline_, other.inline_, sizeof(inline_));
+    other.size_ = 0;
+    other.hash_ = EmptyHash();
+  }
+
+  auto Release() -> void {
+    if (size_ > kInline) KeyArena::Instance().Free(external_, size_);
+  }
+
+  static auto EmptyHash() -> uint32_t {
+    static const auto hash =
+        static_cast<uint32_t>(HashBytes("", 0, HashSeed()) >> 32);
+    return hash;
+  }
+
+  uint32_t hash_{EmptyHash()};
+  uint32_t size_{0};
+  union {
+    char inline_[kInline + 1];
+    char *external_;
+  };
+};
+
+}  // namespace s21
+
+#endif  // A6_COMPACT_KEY_H
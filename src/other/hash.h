@@ -0,0 +1,85 @@
+#ifndef A6_HASH_H
+#define A6_HASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace s21 {
+
+/// @brief Случайное зерно хеш-функции, общее для всего процесса.
+inline auto HashSeed() -> uint64_t {
+  static const uint64_t seed = [] {
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+  }();
+  return seed;
+}
+
+namespace hash_detail {
+
+inline auto Mix(uint64_t a, uint64_t b) -> uint64_t {
+  __uint128_t r = static_cast<__uint128_t>(a) * b;
+  return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+}
+
+inline auto Read64(const unsigned char *p) -> uint64_t {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline auto Read32(const unsigned char *p) -> uint64_t {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+}  // namespace hash_detail
+
+/// @brief 64-битная хеш-функция строк (семейство wyhash): по одному умножению
+/// 64x64->128 на каждые 16 байт ключа. Результат не зависит от размера
+/// таблицы, поэтому его можно вычислить один раз и хранить вместе с записью.
+inline auto HashBytes(const void *data, size_t len, uint64_t seed = HashSeed())
+    -> uint64_t {
+  using hash_detail::Mix;
+  using hash_detail::Read32;
+  using hash_detail::Read64;
+  constexpr uint64_t k0 = 0xa0761d6478bd642full;
+  constexpr uint64_t k1 = 0xe7037ed1a0b428dbull;
+  const auto *p = static_cast<const unsigned char *>(data);
+  uint64_t a = 0;
+  uint64_t b = 0;
+  seed ^= k0;
+  if (len <= 16) {
+    if (len >= 4) {
+      size_t shift = (len >> 3) << 2;
+      a = (Read32(p) << 32) | Read32(p + shift);
+      b = (Read32(p + len - 4) << 32) | Read32(p + len - 4 - shift);
+    } else if (len > 0) {
+      a = (static_cast<uint64_t>(p[0]) << 16) |
+          (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+    }
+  } else {
+    size_t i = len;
+    while (i > 16) {
+      seed = Mix(Read64(p) ^ k1, Read64(p + 8) ^ seed);
+      p += 16;
+      i -= 16;
+    }
+    a = Read64(p + i - 16);
+    b = Read64(p + i - 8);
+  }
+  return Mix(k1 ^ len, Mix(a ^ k1, b ^ seed));
+}
+
+inline auto HashBytes(std::string_view str, uint64_t seed = HashSeed())
+    -> uint64_t {
+  return HashBytes(str.data(), str.size(), seed);
+}
+
+}  // namespace s21
+
+#endif  // A6_HASH_H
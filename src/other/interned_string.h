@@ -0,0 +1,168 @@
+#ifndef A6_INTERNED_STRING_H
+#define A6_INTERNED_STRING_H
+
+#include <array>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace s21 {
+
+/// @brief Общий для процесса словарь строк. Каждой различной строке
+/// выдаётся 32-битный идентификатор; пустая строка всегда имеет номер 0.
+/// Строки никогда не удаляются, поэтому ссылки на них и идентификаторы
+/// остаются действительными всё время работы программы. Память под строки
+/// выделяется кусками по мере роста: каталог страниц, страница кусков,
+/// кусок строк; номера занимают весь неотрицательный диапазон int32, и
+/// раньше этого предела кончится память. Интернирование потокобезопасно,
+/// чтение строки по идентификатору не берёт блокировок.
+class StringDictionary {
+ public:
+  static auto Instance() -> StringDictionary & {
+    static StringDictionary dictionary;
+    return dictionary;
+  }
+
+  StringDictionary(const StringDictionary &) = delete;
+  auto operator=(const StringDictionary &) -> StringDictionary & = delete;
+
+  ~StringDictionary() {
+    for (auto &page : pages_) {
+      Page *chunks = page.load();
+      if (!chunks) continue;
+      for (auto &chunk : chunks->chunks) delete[] chunk.load();
+      delete chunks;
+    }
+  }
+
+  /// @brief Идентификатор строки; строка добавляется, если её ещё нет.
+  auto Intern(std::string_view value) -> uint32_t {
+    {
+      std::shared_lock<std::shared_mutex> lock(mutex_);
+      auto found = ids_.find(value);
+      if (found != ids_.end()) return found->second;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto found = ids_.find(value);
+    if (found != ids_.end()) return found->second;
+    uint32_t id = size_.load(std::memory_order_relaxed);
+    if (id > kMaxId)
+      throw std::length_error("StringDictionary: too many strings");
+    auto &page = pages_[id >> kPageShift];
+    if (!page.load(std::memory_order_relaxed))
+      page.store(new Page, std::memory_order_release);
+    auto &chunk = ChunkOf(id);
+    if (!chunk.load(std::memory_order_relaxed))
+      chunk.store(new std::string[kChunkSize], std::memory_order_release);
+    std::string &slot = chunk.load(std::memory_order_relaxed)[id & kChunkMask];
+    slot = value;
+    ids_.emplace(slot, id);
+    size_.store(id + 1, std::memory_order_release);
+    return id;
+  }
+
+  /// @brief Ищет строку, не добавляя её в словарь.
+  /// @return false, если такой строки в словаре нет
+  auto Lookup(std::string_view value, uint32_t *id) const -> bool {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto found = ids_.find(value);
+    if (found == ids_.end()) return false;
+    *id = found->second;
+    return true;
+  }
+
+  auto Str(uint32_t id) const -> const std::string & {
+    return ChunkOf(id).load(std::memory_order_acquire)[id & kChunkMask];
+  }
+
+  auto Size() const -> size_t {
+    return size_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static constexpr unsigned kChunkBits = 12;
+  static constexpr uint32_t kChunkSize = 1u << kChunkBits;
+  static constexpr uint32_t kChunkMask = kChunkSize - 1;
+  static constexpr unsigned kPageBits = 12;
+  static constexpr unsigned kPageShift = kChunkBits + kPageBits;
+  static constexpr uint32_t kPageMask = (1u << kPageBits) - 1;
+  /// Номера хранятся в индексах как int32, -1 там - "нет значения".
+  static constexpr uint32_t kMaxId = INT32_MAX;
+  static constexpr size_t kMaxPages = (size_t{kMaxId} + 1) >> kPageShift;
+
+  struct Page {
+    std::array<std::atomic<std::string *>, size_t{1} << kPageBits> chunks{};
+  };
+
+  StringDictionary() { Intern(""); }
+
+  auto ChunkOf(uint32_t id) const -> std::atomic<std::string *> & {
+    return pages_[id >> kPageShift]
+        .load(std::memory_order_acquire)
+        ->chunks[(id >> kChunkBits) & kPageMask];
+  }
+
+  std::array<std::atomic<Page *>, kMaxPages> pages_{};
+  std::unordered_map<std::string_view, uint32_t> ids_;
+  std::atomic<uint32_t> size_{0};
+  mutable std::shared_mutex mutex_;
+};
+
+/// @brief Строка, хранимая номером в StringDictionary. Копирование и
+/// сравнение стоят как для целого числа; неявно приводится к std::string
+/// и обратно, поэтому поля Peer используются так же, как обычные строки.
+class InternedString {
+ public:
+  InternedString() = default;
+  InternedString(const std::string &value)
+      : id_(StringDictionary::Instance().Intern(value)) {}
+  InternedString(const char *value)
+      : id_(StringDictionary::Instance().Intern(value)) {}
+
+  operator const std::string &() const { return Str(); }
+
+  auto Str() const -> const std::string & {
+    return StringDictionary::Instance().Str(id_);
+  }
+  auto Id() const -> uint32_t { return id_; }
+  auto Empty() const -> bool { return id_ == 0; }
+
+  /// @brief Находит уже интернированную строку.
+  /// @return false, если такой строки нет ни в одной записи
+  static auto Lookup(const std::string &value, InternedString *out) -> bool {
+    return StringDictionary::Instance().Lookup(value, &out->id_);
+  }
+
+  friend auto operator==(const InternedString &a, const InternedString &b)
+      -> bool {
+    return a.id_ == b.id_;
+  }
+  friend auto operator!=(const InternedString &a, const InternedString &b)
+      -> bool {
+    return a.id_ != b.id_;
+  }
+  friend auto operator<<(std::ostream &out, const InternedString &value)
+      -> std::ostream & {
+    return out << value.Str();
+  }
+  friend auto operator>>(std::istream &in, InternedString &value)
+      -> std::istream & {
+    std::string word;
+    if (in >> word) value = word;
+    return in;
+  }
+
+ private:
+  uint32_t id_{0};
+};
+
+}  // namespace s21
+
+#endif  // A6_INTERNED_STRING_H
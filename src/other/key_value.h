@@ -1,16 +1,26 @@
 #ifndef A6_KEY_VALUE_H
 #define A6_KEY_VALUE_H
 
+#include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#include "compact_key.h"
+#include "interned_string.h"
+
+/// Строковые поля кроме ключа имеют мало различных значений и хранятся
+/// номерами в общем словаре строк; короткий ключ хранится прямо в записи.
+/// Строки словаря не освобождаются и после удаления записей, поэтому
+/// память растёт с числом различных значений этих полей за всё время
+/// работы процесса.
 struct Peer {
-  std::string key{};
-  std::string last_name{};
-  std::string first_name{};
+  s21::CompactKey key{};
+  s21::InternedString last_name{};
+  s21::InternedString first_name{};
   int year_of_birth{0};
-  std::string city{};
+  s21::InternedString city{};
   int number_of_current_coins{0};
 
   auto print() -> void {
@@ -44,13 +54,26 @@ class KeyValue {
     Set({key, last_name, first_name, year_of_birth, city, coins}, ttl);
   }
 
-  virtual auto Set(const Peer &peer, int time_of_life = 0) -> void = 0;
+  virtual auto Set(Peer peer, int time_of_life = 0) -> void = 0;
 
   /// @brief Команда используется для получения значения, связанного с ключом.
   /// @param key
   /// @return Если такой записи нет, то будет возвращён (null):
   virtual auto Get(const std::string &key) -> Peer * = 0;
 
+  /// @brief Копирует запись с ключом key в out. В отличие от указателя из
+  /// Get, копия остаётся верной, даже если запись тут же изменят или удалят
+  /// другие потоки.
+  /// @param key
+  /// @param out
+  /// @return false, если такой записи нет
+  virtual auto GetCopy(const std::string &key, Peer *out) -> bool {
+    Peer *found = Get(key);
+    if (!found) return false;
+    *out = *found;
+    return true;
+  }
+
   /// @brief Эта команда проверяет, существует ли запись с данным ключом.
   /// @param key
   /// @return Возвращает true если объект существует или false если нет:
@@ -79,7 +102,9 @@ class KeyValue {
   /// @return
   virtual auto Keys() -> std::vector<std::string> = 0;
 
-  /// @brief Команда используется для переименования ключей
+  /// @brief Команда используется для переименования ключей. Срок жизни
+  /// записи сохраняется; запись с ключом key_new, если она есть,
+  /// заменяется.
   /// @param key_old
   /// @param key_new
   /// @return
@@ -92,6 +117,38 @@ class KeyValue {
   /// @return Если записи с заданным ключом не существует, то возвращается 0
   virtual auto TTL(const std::string &key) -> int = 0;
 
+  /// @brief Устанавливает время жизни существующего ключа, не меняя значения.
+  /// @param key
+  /// @param seconds если не больше 0, ключ удаляется сразу
+  /// @return Возвращает false, если ключа нет
+  virtual auto Expire(const std::string &key, int seconds) -> bool = 0;
+
+  /// @brief Снимает ограничение времени жизни ключа.
+  /// @param key
+  /// @return Возвращает true, если у ключа было время жизни
+  virtual auto Persist(const std::string &key) -> bool = 0;
+
+  /// @brief Оставшееся время жизни ключа в миллисекундах.
+  /// @param key
+  /// @return -2, если ключа нет, и -1, если время жизни не ограничено
+  virtual auto PTTL(const std::string &key) -> int64_t = 0;
+
+  /// @brief Срок истечения ключа как абсолютное время в миллисекундах по
+  /// монотонным часам Expirer::NowMs.
+  /// @param key
+  /// @return -2, если ключа нет, и -1, если время жизни не ограничено
+  virtual auto PExpireTime(const std::string &key) -> int64_t = 0;
+
+  /// @brief Устанавливает абсолютный срок истечения существующего ключа.
+  /// В отличие от Expire срок не округляется до секунд, поэтому переносит
+  /// срок с ключа на ключ без изменений.
+  /// @param key
+  /// @param deadline время по часам Expirer::NowMs; 0 - без ограничения;
+  /// если срок уже наступил, ключ удаляется сразу
+  /// @return Возвращает false, если ключа нет
+  virtual auto PExpireAt(const std::string &key, int64_t deadline)
+      -> bool = 0;
+
   /// @brief Эта команда используется для восстановления ключа (или ключей) по
   /// заданному значению.
   /// @param last_name
@@ -105,11 +162,38 @@ class KeyValue {
                     int number_of_current_coins)
       -> std::vector<std::string> = 0;
 
+  /// @brief Включает или выключает вторичные индексы по полям значения,
+  /// ускоряющие Find. При включении индексы строятся по текущим данным.
+  /// @param enable
+  /// @return false, если хранилище не поддерживает индексы
+  virtual auto SetIndexing(bool /*enable*/) -> bool { return false; }
+
+  /// @brief Включает или выключает колоночную копию полей значения, по
+  /// которой Find без индексов выполняется векторным сканированием.
+  /// @param enable
+  /// @return false, если хранилище не поддерживает колоночную копию
+  virtual auto SetColumnar(bool /*enable*/) -> bool { return false; }
+
+  /// @brief Задаёт, на сколько частей делится полный обход в Find, Keys и
+  /// ShowAll. Части выполняются параллельно в общем пуле потоков, их
+  /// результаты склеиваются в порядке частей.
+  /// @param parts 0 - по числу ядер, 1 - последовательный обход
+  /// @return false, если хранилище не поддерживает параллельный обход
+  virtual auto SetParallelScan(size_t /*parts*/) -> bool { return false; }
+
   /// @brief Команда для получения всех записей, которые содержатся в key-value
   /// хранилище на текущий момент
   /// @return
   virtual auto ShowAll() -> std::vector<Peer *> = 0;
 
+  /// @brief Цикл активного удаления истёкших ключей. Хранилище запускает его
+  /// само по ходу операций, но его можно вызывать и в периоды простоя.
+  /// @param budget ограничение времени работы цикла
+  /// @return Число удалённых записей
+  virtual auto ActiveExpireCycle(
+      std::chrono::microseconds budget = std::chrono::milliseconds(1))
+      -> size_t = 0;
+
   /// @brief Данная команда используется для загрузки данных из файла.
   /// @param data_directory
   /// @return Выводится число загруженных строк из файла.
@@ -0,0 +1,150 @@
+#ifndef A6_NODE_POOL_H
+#define A6_NODE_POOL_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace s21 {
+
+/// @brief Пул однотипных узлов. Память берётся плитами по kSlabBytes,
+/// выровненными по своему размеру: по адресу узла плита находится маской,
+/// а занятые места отмечены в битовой карте её заголовка. Свободные места
+/// переиспользуются в порядке LIFO, новые выдаются подряд, так что узлы,
+/// созданные вместе, лежат рядом. Clear уничтожает все живые узлы обходом
+/// плит и возвращает память целыми плитами; для тривиально уничтожаемых
+/// типов это O(число плит).
+template <typename T>
+class NodePool {
+ public:
+  static constexpr size_t kSlabBytes = size_t{1} << 16;
+
+  NodePool() = default;
+  NodePool(const NodePool &) = delete;
+  auto operator=(const NodePool &) -> NodePool & = delete;
+  ~NodePool() { Clear(); }
+
+  template <typename... Args>
+  auto New(Args &&...args) -> T * {
+    void *place = Allocate();
+    try {
+      return new (place) T(std::forward<Args>(args)...);
+    } catch (...) {
+      Release(place);
+      throw;
+    }
+  }
+
+  auto Delete(T *object) -> void {
+    object->~T();
+    Release(object);
+  }
+
+  /// @brief Уничтожает все узлы пула и освобождает память.
+  auto Clear() -> void {
+    while (slabs_) {
+      Slab *slab = slabs_;
+      slabs_ = slab->next;
+      if (!std::is_trivially_destructible<T>::value) {
+        for (size_t word = 0; word < kWords; ++word) {
+          for (uint64_t bits = slab->live[word]; bits; bits &= bits - 1)
+            slab->At(word * 64 + __builtin_ctzll(bits))->~T();
+        }
+      }
+      std::free(slab);
+    }
+    free_ = nullptr;
+    cursor_ = nullptr;
+    left_ = 0;
+    size_ = 0;
+  }
+
+  auto Size() const -> size_t { return size_; }
+
+ private:
+  struct FreeSlot {
+    FreeSlot *next;
+  };
+
+  static constexpr size_t kSlotBytes =
+      (sizeof(T) + alignof(T) - 1) / alignof(T) * alignof(T);
+  static constexpr size_t kMaxSlots = kSlabBytes / kSlotBytes;
+  static constexpr size_t kWords = (kMaxSlots + 63) / 64;
+
+  struct Slab {
+    Slab *next;
+    uint64_t live[kWords];
+
+    static auto Offset() -> size_t {
+      return (sizeof(Slab) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+    auto At(size_t i) -> T * {
+      return reinterpret_cast<T *>(reinterpret_cast<char *>(this) + Offset() +
+                                   i * kSlotBytes);
+    }
+    auto IndexOf(const void *place) const -> size_t {
+      return (static_cast<const char *>(place) -
+              reinterpret_cast<const char *>(this) - Offset()) /
+             kSlotBytes;
+    }
+  };
+
+  static constexpr size_t kSlots =
+      (kSlabBytes - (sizeof(Slab) + alignof(T))) / kSlotBytes;
+  static_assert(kSlots >= 8, "NodePool: node is too large for a slab");
+  static_assert(sizeof(T) >= sizeof(FreeSlot), "NodePool: node is too small");
+  static_assert(alignof(T) <= 4096, "NodePool: alignment is too large");
+
+  static auto SlabOf(const void *place) -> Slab * {
+    return reinterpret_cast<Slab *>(reinterpret_cast<uintptr_t>(place) &
+                                    ~(kSlabBytes - 1));
+  }
+
+  auto Allocate() -> void * {
+    void *place;
+    if (free_) {
+      place = free_;
+      free_ = free_->next;
+    } else {
+      if (!left_) {
+        void *memory = std::aligned_alloc(kSlabBytes, kSlabBytes);
+        if (!memory) throw std::bad_alloc();
+        auto *slab = new (memory) Slab{slabs_, {}};
+        slabs_ = slab;
+        cursor_ = slab->At(0);
+        left_ = kSlots;
+      }
+      place = cursor_;
+      cursor_ = reinterpret_cast<T *>(reinterpret_cast<char *>(cursor_) +
+                                      kSlotBytes);
+      --left_;
+    }
+    Slab *slab = SlabOf(place);
+    size_t i = slab->IndexOf(place);
+    slab->live[i / 64] |= uint64_t{1} << (i % 64);
+    ++size_;
+    return place;
+  }
+
+  auto Release(void *place) -> void {
+    Slab *slab = SlabOf(place);
+    size_t i = slab->IndexOf(place);
+    slab->live[i / 64] &= ~(uint64_t{1} << (i % 64));
+    auto *slot = static_cast<FreeSlot *>(place);
+    slot->next = free_;
+    free_ = slot;
+    --size_;
+  }
+
+  Slab *slabs_ = nullptr;
+  FreeSlot *free_ = nullptr;
+  T *cursor_ = nullptr;
+  size_t left_ = 0;
+  size_t size_ = 0;
+};
+
+}  // namespace s21
+
+#endif  // A6_NODE_POOL_H
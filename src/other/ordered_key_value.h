@@ -0,0 +1,88 @@
+#ifndef A6_ORDERED_KEY_VALUE_H
+#define A6_ORDERED_KEY_VALUE_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "key_value.h"
+
+/// @brief Хранилище, в котором записи упорядочены по ключу. Позволяет
+/// обходить диапазоны ключей: поиск начала стоит O(log n), дальше записи
+/// выдаются по одной без построения полного списка.
+class OrderedKeyValue : public KeyValue {
+ public:
+  /// Вызывается для каждой записи диапазона; false прекращает обход.
+  /// Менять хранилище во время обхода нельзя.
+  using Visitor = std::function<bool(const Peer &)>;
+
+  using KeyValue::Keys;
+
+  /// @brief Обходит записи с ключами из [from, to).
+  /// @param from пустая строка - от наименьшего ключа
+  /// @param to пустая строка - до наибольшего ключа включительно
+  /// @param visit
+  /// @param reverse обход по убыванию ключей
+  virtual auto ScanRange(const std::string &from, const std::string &to,
+                         const Visitor &visit, bool reverse = false)
+      -> void = 0;
+
+  /// @brief Страница ключей по порядку: не более limit ключей, начиная с
+  /// ключа номер offset. Реализация по умолчанию пропускает первые offset
+  /// записей обходом.
+  /// @param offset
+  /// @param limit 0 - до конца
+  /// @return
+  virtual auto Keys(size_t offset, size_t limit) -> std::vector<std::string> {
+    std::vector<std::string> result;
+    ScanRange("", "", [&result, &offset, limit](const Peer &peer) {
+      if (offset) {
+        --offset;
+        return true;
+      }
+      result.push_back(peer.key);
+      return limit == 0 || result.size() < limit;
+    });
+    return result;
+  }
+
+  /// @brief Не более limit ключей из [from, to) по порядку.
+  /// @param from
+  /// @param to
+  /// @param limit 0 - без ограничения
+  /// @param reverse
+  /// @return
+  auto Scan(const std::string &from, const std::string &to, size_t limit,
+            bool reverse = false) -> std::vector<std::string> {
+    std::vector<std::string> result;
+    ScanRange(
+        from, to,
+        [&result, limit](const Peer &peer) {
+          result.push_back(peer.key);
+          return limit == 0 || result.size() < limit;
+        },
+        reverse);
+    return result;
+  }
+
+  /// @brief Не более limit ключей, начинающихся с prefix, по порядку.
+  /// @param prefix
+  /// @param limit 0 - без ограничения
+  /// @param reverse
+  /// @return
+  auto ScanPrefix(const std::string &prefix, size_t limit,
+                  bool reverse = false) -> std::vector<std::string> {
+    return Scan(prefix, PrefixEnd(prefix), limit, reverse);
+  }
+
+  /// @brief Наименьшая строка, большая всех строк с данным префиксом;
+  /// пустая, если такой нет.
+  static auto PrefixEnd(std::string prefix) -> std::string {
+    while (!prefix.empty() && static_cast<unsigned char>(prefix.back()) == 0xFF)
+      prefix.pop_back();
+    if (!prefix.empty()) ++prefix.back();
+    return prefix;
+  }
+};
+
+#endif  // A6_ORDERED_KEY_VALUE_H
@@ -0,0 +1,114 @@
+#ifndef A6_RECORD_LOADER_H
+#define A6_RECORD_LOADER_H
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "key_value.h"
+#include "worker_pool.h"
+
+namespace s21 {
+
+namespace record_loader_detail {
+
+constexpr size_t kMinChunk = 1 << 20;
+
+inline auto NextToken(const char *&p, const char *end) -> std::string_view {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+  const char *start = p;
+  while (p < end && !std::isspace(static_cast<unsigned char>(*p))) ++p;
+  return {start, static_cast<size_t>(p - start)};
+}
+
+inline auto ToInt(std::string_view token) -> int {
+  int value = 0;
+  std::from_chars(token.data(), token.data() + token.size(), value);
+  return value;
+}
+
+// Разбирает строки из [begin, end); кусок начинается с начала строки и
+// заканчивается сразу после перевода строки или концом файла.
+inline auto ParseChunk(const char *begin, const char *end)
+    -> std::vector<Peer> {
+  std::vector<Peer> peers;
+  peers.reserve(std::count(begin, end, '\n') + 1);
+  std::string field;
+  for (const char *p = begin; p < end;) {
+    const char *eol = std::find(p, end, '\n');
+    Peer peer;
+    std::string_view key = NextToken(p, eol);
+    peer.key = field.assign(key.data(), key.size());
+    std::string_view last_name = NextToken(p, eol);
+    peer.last_name = field.assign(last_name.data(), last_name.size());
+    std::string_view first_name = NextToken(p, eol);
+    peer.first_name = field.assign(first_name.data(), first_name.size());
+    peer.year_of_birth = ToInt(NextToken(p, eol));
+    std::string_view city = NextToken(p, eol);
+    peer.city = field.assign(city.data(), city.size());
+    peer.number_of_current_coins = ToInt(NextToken(p, eol));
+    if (!key.empty()) peers.push_back(std::move(peer));
+    p = eol + 1;
+  }
+  return peers;
+}
+
+}  // namespace record_loader_detail
+
+/// @brief Разбирает файл в формате ExportData. Файл читается в память
+/// одним блоком и делится на куски по границам строк, куски разбираются
+/// параллельно в WorkerPool. Последняя строка разбирается и без
+/// завершающего перевода строки; пустые строки пропускаются.
+/// @param path
+/// @param threads число кусков; 0 - по числу ядер
+/// @return записи по кускам в порядке файла; пусто, если файл не открылся
+inline auto ParseRecords(const std::string &path, size_t threads = 0)
+    -> std::vector<std::vector<Peer>> {
+  using record_loader_detail::kMinChunk;
+  // Каталог открывается как поток, но размер у него не определён.
+  std::error_code error;
+  if (!std::filesystem::is_regular_file(path, error)) return {};
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) return {};
+  file.seekg(0, std::ios_base::end);
+  std::streamoff size = file.tellg();
+  if (size < 0) return {};
+  std::string data(static_cast<size_t>(size), '\0');
+  file.seekg(0, std::ios_base::beg);
+  file.read(data.data(), static_cast<std::streamsize>(data.size()));
+  file.close();
+
+  if (threads == 0) threads = WorkerCount();
+  size_t chunks = std::clamp<size_t>(data.size() / kMinChunk, 1, threads);
+  const char *end = data.data() + data.size();
+  std::vector<const char *> bounds{data.data()};
+  for (size_t i = 1; i < chunks; ++i) {
+    const char *middle = data.data() + data.size() * i / chunks;
+    const char *bound = std::find(std::max(bounds.back(), middle), end, '\n');
+    bounds.push_back(bound == end ? end : bound + 1);
+  }
+  bounds.push_back(end);
+
+  std::vector<std::vector<Peer>> batches(chunks);
+  WorkerPool::Instance().Run(chunks, [&batches, &bounds](size_t i) {
+    batches[i] = record_loader_detail::ParseChunk(bounds[i], bounds[i + 1]);
+  });
+  return batches;
+}
+
+/// @brief Общее число записей во всех кусках.
+inline auto RecordCount(const std::vector<std::vector<Peer>> &batches)
+    -> int {
+  size_t count = 0;
+  for (const auto &batch : batches) count += batch.size();
+  return static_cast<int>(count);
+}
+
+}  // namespace s21
+
+#endif  // A6_RECORD_LOADER_H
@@ -0,0 +1,137 @@
+#ifndef A6_WORKER_POOL_H
+#define A6_WORKER_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace s21 {
+
+/// @brief Число рабочих потоков для параллельных операций хранилищ.
+inline auto WorkerCount() -> size_t {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/// @brief Общий для процесса пул потоков. Run делит работу на части,
+/// которые разбирают потоки пула вместе с вызывающим потоком; поэтому Run
+/// можно вызывать и из задачи, уже выполняемой пулом, - вызывающий поток
+/// сам доделает части, до которых пул не дошёл.
+class WorkerPool {
+ public:
+  static auto Instance() -> WorkerPool & {
+    static WorkerPool pool(WorkerCount() - 1);
+    return pool;
+  }
+
+  WorkerPool(const WorkerPool &) = delete;
+  auto operator=(const WorkerPool &) -> WorkerPool & = delete;
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto &worker : workers_) worker.join();
+  }
+
+  /// @brief Выполняет task(part) для каждой части из [0, parts) и ждёт
+  /// завершения всех частей.
+  template <typename Func>
+  auto Run(size_t parts, Func task) -> void {
+    if (parts <= 1 || workers_.empty()) {
+      for (size_t part = 0; part < parts; ++part) task(part);
+      return;
+    }
+    auto state = std::make_shared<Batch>();
+    state->parts = parts;
+    state->task = [&task](size_t part) { task(part); };
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (size_t i = 0; i < std::min(parts - 1, workers_.size()); ++i)
+        queue_.push_back(state);
+    }
+    wake_.notify_all();
+    Drain(*state);
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done_cv.wait(lock,
+                        [&state] { return state->done == state->parts; });
+  }
+
+  /// @brief Каждая часть заполняет свой вектор вызовом fill(part, &out);
+  /// векторы склеиваются в порядке частей.
+  template <typename T, typename Func>
+  auto Gather(size_t parts, Func fill) -> std::vector<T> {
+    if (parts == 0) return {};
+    std::vector<std::vector<T>> pieces(parts);
+    Run(parts, [&pieces, &fill](size_t part) { fill(part, &pieces[part]); });
+    size_t total = 0;
+    for (const auto &piece : pieces) total += piece.size();
+    std::vector<T> result = std::move(pieces.front());
+    result.reserve(total);
+    for (size_t i = 1; i < parts; ++i) {
+      result.insert(result.end(), std::make_move_iterator(pieces[i].begin()),
+                    std::make_move_iterator(pieces[i].end()));
+    }
+    return result;
+  }
+
+  auto Threads() const -> size_t { return workers_.size() + 1; }
+
+ private:
+  /// Части одного вызова Run. Задача вызывается только для взятых частей,
+  /// а Run не возвращается, пока они не выполнены, поэтому ссылка на
+  /// задачу вызывающего остаётся действительной.
+  struct Batch {
+    size_t parts = 0;
+    std::function<void(size_t)> task;
+    std::atomic<size_t> next{0};
+    size_t done = 0;
+    std::mutex mutex;
+    std::condition_variable done_cv;
+  };
+
+  explicit WorkerPool(size_t threads) {
+    for (size_t i = 0; i < threads; ++i)
+      workers_.emplace_back([this] { Work(); });
+  }
+
+  static auto Drain(Batch &batch) -> void {
+    for (size_t part = batch.next++; part < batch.parts;
+         part = batch.next++) {
+      batch.task(part);
+      std::lock_guard<std::mutex> lock(batch.mutex);
+      if (++batch.done == batch.parts) batch.done_cv.notify_all();
+    }
+  }
+
+  auto Work() -> void {
+    while (true) {
+      std::shared_ptr<Batch> batch;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) return;
+        batch = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      Drain(*batch);
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::deque<std::shared_ptr<Batch>> queue_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+};
+
+}  // namespace s21
+
+#endif  // A6_WORKER_POOL_H
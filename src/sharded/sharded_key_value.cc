@@ -0,0 +1,282 @@
+#include "sharded_key_value.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "../other/hash.h"
+#include "../other/ordered_key_value.h"
+#include "../other/record_loader.h"
+#include "../other/worker_pool.h"
+
+namespace s21 {
+
+ShardedKeyValue::ShardedKeyValue(const Factory &make, size_t shards,
+                                 std::chrono::milliseconds expire_period) {
+  shards_.reserve(std::max<size_t>(shards, 1));
+  for (size_t i = 0; i < std::max<size_t>(shards, 1); ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+    shards_.back()->storage = make();
+  }
+  ordered_ = dynamic_cast<OrderedKeyValue *>(shards_.front()->storage.get());
+  if (expire_period.count() > 0) {
+    expirer_ =
+        std::thread([this, expire_period] { ExpireLoop(expire_period); });
+  }
+}
+
+ShardedKeyValue::~ShardedKeyValue() {
+  {
+    std::lock_guard<std::mutex> lock(stop_mutex_);
+    stopping_ = true;
+  }
+  stop_.notify_all();
+  if (expirer_.joinable()) expirer_.join();
+}
+
+// Шард выбирается по старшим битам хеша с отдельным зерном: младшие биты
+// того же хеша движок шарда использует для выбора своих групп.
+auto ShardedKeyValue::ShardIndex(std::string_view key) const -> size_t {
+  static const uint64_t seed = HashSeed() ^ 0x9e3779b97f4a7c15ull;
+  uint64_t hash = HashBytes(key.data(), key.size(), seed) >> 32;
+  return static_cast<size_t>((hash * shards_.size()) >> 32);
+}
+
+// Обходит шарды по очереди, удерживая блокировку только текущего.
+template <typename Func>
+auto ShardedKeyValue::EachShard(Func func) -> void {
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    func(*shard->storage);
+  }
+}
+
+// Шарды обходятся параллельно, каждый под своей блокировкой;
+// func(storage, &out) добавляет результаты шарда в его вектор.
+template <typename T, typename Func>
+auto ShardedKeyValue::GatherShards(Func func) -> std::vector<T> {
+  return WorkerPool::Instance().Gather<T>(
+      shards_.size(), [this, &func](size_t i, std::vector<T> *out) {
+        std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+        func(*shards_[i]->storage, out);
+      });
+}
+
+auto ShardedKeyValue::Set(Peer peer, int time_of_life) -> void {
+  Shard &shard = ShardOf(peer.key.View());
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.storage->Set(std::move(peer), time_of_life);
+}
+
+auto ShardedKeyValue::Get(const std::string &key) -> Peer * {
+  thread_local Peer copy;
+  return GetCopy(key, &copy) ? &copy : nullptr;
+}
+
+auto ShardedKeyValue::GetCopy(const std::string &key, Peer *out) -> bool {
+  Shard &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.storage->GetCopy(key, out);
+}
+
+auto ShardedKeyValue::Exists(const std::string &key) -> bool {
+  Shard &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.storage->Exists(key);
+}
+
+auto ShardedKeyValue::Del(const std::string &key) -> bool {
+  Shard &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.storage->Del(key);
+}
+
+auto ShardedKeyValue::Update(const std::string &key,
+                             const std::string &last_name,
+                             const std::string &first_name, int year_of_birth,
+                             const std::string &city,
+                             int number_of_current_coins) -> void {
+  Shard &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.storage->Update(key, last_name, first_name, year_of_birth, city,
+                        number_of_current_coins);
+}
+
+auto ShardedKeyValue::Keys() -> std::vector<std::string> {
+  auto result = GatherShards<std::string>(
+      [](KeyValue &storage, std::vector<std::string> *out) {
+        *out = storage.Keys();
+      });
+  if (ordered_) std::sort(result.begin(), result.end());
+  return result;
+}
+
+// Оба шарда блокируются вместе, поэтому другие потоки не видят
+// промежуточного состояния, когда запись есть в обоих или ни в одном.
+auto ShardedKeyValue::Rename(const std::string &key_old,
+                             const std::string &key_new) -> void {
+  Shard &from = ShardOf(key_old);
+  Shard &to = ShardOf(key_new);
+  if (&from == &to) {
+    std::lock_guard<std::mutex> lock(from.mutex);
+    from.storage->Rename(key_old, key_new);
+    return;
+  }
+  std::scoped_lock lock(from.mutex, to.mutex);
+  Peer *found = from.storage->Get(key_old);
+  if (!found) return;
+  Peer peer = *found;
+  int64_t deadline = from.storage->PExpireTime(key_old);
+  from.storage->Del(key_old);
+  to.storage->Del(key_new);
+  peer.key = key_new;
+  to.storage->Set(std::move(peer));
+  if (deadline > 0) to.storage->PExpireAt(key_new, deadline);
+}
+
+auto ShardedKeyValue::TTL(const std::string &key) -> int {
+  Shard &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.storage->TTL(key);
+}
+
+auto ShardedKeyValue::Expire(const std::string &key, int seconds) -> bool {
+  Shard &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.storage->Expire(key, seconds);
+}
+
+auto ShardedKeyValue::Persist(const std::string &key) -> bool {
+  Shard &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.storage->Persist(key);
+}
+
+auto ShardedKeyValue::PTTL(const std::string &key) -> int64_t {
+  Shard &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.storage->PTTL(key);
+}
+
+auto ShardedKeyValue::PExpireTime(const std::string &key) -> int64_t {
+  Shard &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.storage->PExpireTime(key);
+}
+
+auto ShardedKeyValue::PExpireAt(const std::string &key, int64_t deadline)
+    -> bool {
+  Shard &shard = ShardOf(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.storage->PExpireAt(key, deadline);
+}
+
+auto ShardedKeyValue::Find(const std::string &last_name,
+                           const std::string &first_name, int year_of_birth,
+                           const std::string &city,
+                           int number_of_current_coins)
+    -> std::vector<std::string> {
+  auto result = GatherShards<std::string>(
+      [&](KeyValue &storage, std::vector<std::string> *out) {
+        *out = storage.Find(last_name, first_name, year_of_birth, city,
+                            number_of_current_coins);
+      });
+  if (ordered_) std::sort(result.begin(), result.end());
+  return result;
+}
+
+auto ShardedKeyValue::SetIndexing(bool enable) -> bool {
+  bool result = true;
+  EachShard([&](KeyValue &storage) { result &= storage.SetIndexing(enable); });
+  return result;
+}
+
+auto ShardedKeyValue::SetColumnar(bool enable) -> bool {
+  bool result = true;
+  EachShard([&](KeyValue &storage) { result &= storage.SetColumnar(enable); });
+  return result;
+}
+
+auto ShardedKeyValue::SetParallelScan(size_t parts) -> bool {
+  bool result = true;
+  EachShard(
+      [&](KeyValue &storage) { result &= storage.SetParallelScan(parts); });
+  return result;
+}
+
+auto ShardedKeyValue::ShowAll() -> std::vector<Peer *> {
+  thread_local std::vector<Peer> copies;
+  copies = GatherShards<Peer>([](KeyValue &storage, std::vector<Peer> *out) {
+    for (const Peer *peer : storage.ShowAll()) out->push_back(*peer);
+  });
+  if (ordered_) {
+    std::sort(copies.begin(), copies.end(),
+              [](const Peer &a, const Peer &b) { return a.key < b.key; });
+  }
+  std::vector<Peer *> result;
+  result.reserve(copies.size());
+  for (Peer &peer : copies) result.push_back(&peer);
+  return result;
+}
+
+auto ShardedKeyValue::ActiveExpireCycle(std::chrono::microseconds budget)
+    -> size_t {
+  size_t reclaimed = 0;
+  auto share = budget / shards_.size();
+  EachShard([&](KeyValue &storage) {
+    reclaimed += storage.ActiveExpireCycle(share);
+  });
+  return reclaimed;
+}
+
+auto ShardedKeyValue::ExpireLoop(std::chrono::milliseconds period) -> void {
+  std::unique_lock<std::mutex> lock(stop_mutex_);
+  while (!stop_.wait_for(lock, period, [this] { return stopping_; })) {
+    lock.unlock();
+    ActiveExpireCycle();
+    lock.lock();
+  }
+}
+
+auto ShardedKeyValue::Upload(const std::string &data_directory) -> int {
+  auto chunks = ParseRecords(data_directory);
+  int lines = RecordCount(chunks);
+  std::vector<std::vector<std::vector<Peer>>> batches(chunks.size());
+  WorkerPool &pool = WorkerPool::Instance();
+  pool.Run(chunks.size(), [this, &chunks, &batches](size_t i) {
+    batches[i].resize(shards_.size());
+    for (Peer &peer : chunks[i])
+      batches[i][ShardIndex(peer.key.View())].push_back(std::move(peer));
+  });
+  pool.Run(shards_.size(), [this, &batches](size_t i) {
+    std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+    KeyValue &storage = *shards_[i]->storage;
+    for (auto &chunk : batches) {
+      for (Peer &peer : chunk[i]) storage.Set(std::move(peer));
+    }
+  });
+  return lines;
+}
+
+// Шарды выгружаются по очереди под своей блокировкой; общий порядок
+// ключей в файле не поддерживается.
+auto ShardedKeyValue::ExportData(const std::string &data_directory) -> int {
+  std::ofstream file(data_directory);
+  int lines = 0;
+  if (file.is_open()) {
+    EachShard([&file, &lines](KeyValue &storage) {
+      for (const Peer *peer : storage.ShowAll()) {
+        file << peer->key << " ";
+        file << peer->last_name << " ";
+        file << peer->first_name << " ";
+        file << peer->year_of_birth << " ";
+        file << peer->city << " ";
+        file << peer->number_of_current_coins << "\n";
+        ++lines;
+      }
+    });
+    file.close();
+  }
+  return lines;
+}
+
+}  // namespace s21
@@ -0,0 +1,123 @@
+#ifndef A6_SHARDED_KEY_VALUE_H
+#define A6_SHARDED_KEY_VALUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../other/key_value.h"
+
+namespace s21 {
+
+/// @brief Потокобезопасное хранилище из нескольких независимых движков
+/// (шардов). Ключ направляется в шард по хешу; у каждого шарда своя
+/// блокировка и своё состояние истечения, поэтому операции с ключами разных
+/// шардов идут параллельно. Keys, Find, ShowAll, Upload и ExportData
+/// обходят все шарды и объединяют результаты; Keys, Find и ShowAll
+/// обходят шарды параллельно в WorkerPool. Для упорядоченных движков
+/// ключи в результате отсортированы. Фоновый поток периодически запускает
+/// активное истечение в каждом шарде.
+///
+/// Get и ShowAll копируют записи под блокировкой шарда и возвращают
+/// указатели на копии: записи в шарде может удалить в любой момент другой
+/// поток, в том числе фоновый поток истечения. Копии принадлежат
+/// вызывающему потоку и действительны до его следующего вызова того же
+/// метода у любого ShardedKeyValue; изменения через эти указатели в
+/// хранилище не попадают.
+class ShardedKeyValue : public KeyValue {
+ public:
+  using Factory = std::function<std::unique_ptr<KeyValue>()>;
+
+  static constexpr size_t kDefaultShards = 16;
+
+  /// @param make создаёт пустой движок для шарда
+  /// @param shards число шардов
+  /// @param expire_period период фонового истечения; 0 - без фонового
+  /// потока
+  explicit ShardedKeyValue(
+      const Factory &make, size_t shards = kDefaultShards,
+      std::chrono::milliseconds expire_period = std::chrono::milliseconds(100));
+  ~ShardedKeyValue() override;
+
+  ShardedKeyValue(const ShardedKeyValue &) = delete;
+  auto operator=(const ShardedKeyValue &) -> ShardedKeyValue & = delete;
+
+  using KeyValue::Set;
+  auto Set(Peer peer, int time_of_life = 0) -> void override;
+  auto Get(const std::string &key) -> Peer * override;
+  auto GetCopy(const std::string &key, Peer *out) -> bool override;
+  auto Exists(const std::string &key) -> bool override;
+  auto Del(const std::string &key) -> bool override;
+  auto Update(const std::string &key, const std::string &last_name = "",
+              const std::string &first_name = "", int year_of_birth = 0,
+              const std::string &city = "", int number_of_current_coins = 0)
+      -> void override;
+  auto Keys() -> std::vector<std::string> override;
+
+  /// @brief Переименование между шардами переносит копию записи вместе с
+  /// абсолютным сроком истечения.
+  /// @param key_old
+  /// @param key_new
+  auto Rename(const std::string &key_old, const std::string &key_new)
+      -> void override;
+  auto TTL(const std::string &key) -> int override;
+  auto Expire(const std::string &key, int seconds) -> bool override;
+  auto Persist(const std::string &key) -> bool override;
+  auto PTTL(const std::string &key) -> int64_t override;
+  auto PExpireTime(const std::string &key) -> int64_t override;
+  auto PExpireAt(const std::string &key, int64_t deadline) -> bool override;
+  auto Find(const std::string &last_name = "",
+            const std::string &first_name = "", int year_of_birth = 0,
+            const std::string &city = "", int number_of_current_coins = -1)
+      -> std::vector<std::string> override;
+  auto SetIndexing(bool enable) -> bool override;
+  auto SetColumnar(bool enable) -> bool override;
+  auto SetParallelScan(size_t parts) -> bool override;
+  auto ShowAll() -> std::vector<Peer *> override;
+
+  /// @brief Запускает цикл истечения в каждом шарде, деля бюджет поровну.
+  auto ActiveExpireCycle(
+      std::chrono::microseconds budget = std::chrono::milliseconds(1))
+      -> size_t override;
+
+  /// @brief Куски файла разбираются и раскладываются по шардам
+  /// параллельно, затем все шарды заполняются одновременно.
+  auto Upload(const std::string &data_directory) -> int override;
+  auto ExportData(const std::string &data_directory) -> int override;
+
+  auto ShardCount() const -> size_t { return shards_.size(); }
+
+ private:
+  struct Shard {
+    std::mutex mutex;
+    std::unique_ptr<KeyValue> storage;
+  };
+
+  auto ShardIndex(std::string_view key) const -> size_t;
+  auto ShardOf(std::string_view key) -> Shard & {
+    return *shards_[ShardIndex(key)];
+  }
+  template <typename Func>
+  auto EachShard(Func func) -> void;
+  template <typename T, typename Func>
+  auto GatherShards(Func func) -> std::vector<T>;
+  auto ExpireLoop(std::chrono::milliseconds period) -> void;
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  bool ordered_ = false;
+
+  std::thread expirer_;
+  std::mutex stop_mutex_;
+  std::condition_variable stop_;
+  bool stopping_ = false;
+};
+
+}  // namespace s21
+
+#endif  // A6_SHARDED_KEY_VALUE_H
@@ -0,0 +1,100 @@
+#ifndef A6_B_PLUS_TREE_TEST_H
+#define A6_B_PLUS_TREE_TEST_H
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include "../btree/b_plus_tree.h"
+
+TEST(b_plus_tree, matches_ordered_map_under_churn) {
+  s21::BPlusTree storage;
+  std::map<std::string, int> model;
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<int> dist(0, 19999);
+  for (int i = 0; i < 120000; ++i) {
+    std::string key = "k" + std::to_string(dist(gen));
+    if (i % 5 < 2) {
+      ASSERT_EQ(storage.Del(key), model.erase(key) == 1);
+    } else {
+      storage.Set({key, "Zzbtree", "Ivan", 1990, "Omsk", i});
+      model.emplace(key, i);
+    }
+  }
+  auto keys = storage.Keys();
+  ASSERT_EQ(keys.size(), model.size());
+  auto it = model.begin();
+  for (const auto &key : keys) {
+    ASSERT_EQ(key, it->first);
+    ASSERT_EQ(storage.Get(key)->number_of_current_coins, it->second);
+    ++it;
+  }
+  double n = static_cast<double>(model.size());
+  ASSERT_LE(storage.Height(),
+            1 + std::ceil(std::log(n) / std::log(s21::BPlusTree::kSlots / 2)));
+  for (const auto &entry : model) ASSERT_TRUE(storage.Del(entry.first));
+  ASSERT_TRUE(storage.Keys().empty());
+  ASSERT_EQ(storage.Height(), 1);
+}
+
+TEST(b_plus_tree, scans) {
+  s21::BPlusTree storage;
+  for (int i = 0; i < 1000; ++i) {
+    std::string key = std::to_string(i);
+    storage.Set({"k" + std::string(3 - key.size(), '0') + key, "Zzscan",
+                 "Ivan", 1990, "Omsk", i});
+  }
+  using Keys = std::vector<std::string>;
+  ASSERT_EQ(storage.Scan("k100", "k103", 0), (Keys{"k100", "k101", "k102"}));
+  ASSERT_EQ(storage.Scan("k100", "k103", 0, true),
+            (Keys{"k102", "k101", "k100"}));
+  ASSERT_EQ(storage.Scan("", "", 2, true), (Keys{"k999", "k998"}));
+  ASSERT_EQ(storage.ScanPrefix("k05", 0).size(), 10);
+  ASSERT_EQ(storage.ScanPrefix("k99", 2), (Keys{"k990", "k991"}));
+  ASSERT_TRUE(storage.ScanPrefix("x", 0).empty());
+  ASSERT_TRUE(storage.Scan("", "k000", 0, true).empty());
+}
+
+TEST(b_plus_tree, ttl_rename_find) {
+  s21::BPlusTree storage;
+  storage.Set({"a", "Zzbp", "Ivan", 1990, "Omsk", 1}, 100);
+  storage.Set({"b", "Zzbp", "Petr", 1991, "Omsk", 2});
+  ASSERT_GT(storage.PTTL("a"), 0);
+  ASSERT_EQ(storage.PTTL("b"), -1);
+  storage.Rename("a", "c");
+  ASSERT_FALSE(storage.Exists("a"));
+  ASSERT_GT(storage.PTTL("c"), 0);
+  ASSERT_TRUE(storage.Persist("c"));
+  ASSERT_EQ(storage.Find("Zzbp"), (std::vector<std::string>{"b", "c"}));
+  storage.SetIndexing(true);
+  ASSERT_EQ(storage.Find("Zzbp", "Petr"), std::vector<std::string>{"b"});
+  ASSERT_TRUE(storage.Expire("b", 0));
+  ASSERT_EQ(storage.Find("Zzbp"), std::vector<std::string>{"c"});
+  ASSERT_EQ(storage.Upload("1000.dat"), 1000);
+  ASSERT_EQ(storage.ExportData("bptree.dat"), 1001);
+  std::remove("bptree.dat");
+}
+
+TEST(b_plus_tree, rename_moves_record) {
+  CheckRenameMovesRecord<s21::BPlusTree>();
+}
+
+TEST(b_plus_tree, keys_page) {
+  s21::BPlusTree storage;
+  std::vector<std::string> sorted;
+  for (int i = 0; i < 2000; i += 3) sorted.push_back(std::to_string(i));
+  std::sort(sorted.begin(), sorted.end());
+  for (const auto &key : sorted)
+    storage.Set({key, "Zzrank", "Ivan", 1990, "Omsk", 0});
+  ASSERT_EQ(storage.Keys(100, 50),
+            std::vector<std::string>(sorted.begin() + 100,
+                                     sorted.begin() + 150));
+  ASSERT_EQ(storage.Keys(sorted.size() - 3, 50).size(), 3);
+}
+
+TEST(b_plus_tree, parallel_scan_keeps_key_order) {
+  auto keys = CheckParallelScanMatchesSequential<s21::BPlusTree>();
+  ASSERT_EQ(keys.size(), 69999);
+  ASSERT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+}
+
+#endif  // A6_B_PLUS_TREE_TEST_H
@@ -0,0 +1,30 @@
+#ifndef A6_COLUMN_STORE_TEST_H
+#define A6_COLUMN_STORE_TEST_H
+#include <gtest/gtest.h>
+
+#include "../index/column_store.h"
+
+TEST(column_store, range_select) {
+  s21::ColumnStore store;
+  for (int i = 0; i < 1000; ++i) {
+    store.Insert({std::to_string(i), i % 2 ? "odd" : "even", "x", 1900 + i,
+                  "y", i % 10});
+  }
+  using Field = s21::ColumnStore::Field;
+  auto keys = store.Select({{Field::kYearOfBirth, 2000, 2099},
+                            {Field::kLastName, store.Encode("odd"),
+                             store.Encode("odd")}});
+  ASSERT_EQ(keys.size(), 50);
+  for (const auto &key : keys) {
+    int i = std::stoi(key);
+    ASSERT_TRUE(i >= 100 && i < 200 && i % 2);
+  }
+  ASSERT_EQ(store.Select({{Field::kCoins, 3, 3}}).size(), 100);
+  for (int i = 0; i < 1000; i += 3) store.Erase(std::to_string(i));
+  ASSERT_EQ(store.Size(), 666);
+  ASSERT_EQ(store.Find({"", "", 1901, "", 1}), std::vector<std::string>{"1"});
+  ASSERT_TRUE(store.Find({"", "", 1903, "", -1}).empty());
+  ASSERT_EQ(store.Encode("missing"), -1);
+}
+
+#endif  // A6_COLUMN_STORE_TEST_H
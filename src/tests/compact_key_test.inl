@@ -0,0 +1,56 @@
+#ifndef A6_COMPACT_KEY_TEST_H
+#define A6_COMPACT_KEY_TEST_H
+#include <gtest/gtest.h>
+
+#include "../other/compact_key.h"
+
+TEST(compact_key, inline_and_overflow) {
+  std::string long_key(s21::CompactKey::kInline + 10, 'x');
+  s21::CompactKey short_key("abc123");
+  s21::CompactKey overflow(long_key);
+  ASSERT_TRUE(short_key.Inline());
+  ASSERT_FALSE(overflow.Inline());
+  ASSERT_EQ(static_cast<std::string>(overflow), long_key);
+
+  s21::CompactKey copy = overflow;
+  ASSERT_EQ(copy, overflow);
+  s21::CompactKey moved = std::move(copy);
+  ASSERT_EQ(moved, long_key);
+  ASSERT_EQ(copy.Size(), 0);
+  ASSERT_EQ(copy, s21::CompactKey());
+  moved = short_key;
+  ASSERT_EQ(moved, "abc123");
+  ASSERT_NE(moved, overflow);
+}
+
+TEST(compact_key, ordering) {
+  s21::CompactKey a("abc"), ab("abcd"), b("abd");
+  ASSERT_TRUE(a < ab);
+  ASSERT_TRUE(ab < b);
+  ASSERT_TRUE(b > a);
+  ASSERT_EQ(a.Compare("abc"), 0);
+  ASSERT_LT(a.Compare("abcd"), 0);
+  ASSERT_GT(b.Compare("ab"), 0);
+}
+
+TEST(compact_key, long_keys_in_storage) {
+  s21::HashTable hash;
+  s21::SelfBalancingBinarySearchTree tree;
+  std::vector<std::string> keys;
+  for (int i = 0; i < 200; ++i)
+    keys.push_back("a_rather_long_key_name_" + std::to_string(i));
+  for (const auto &key : keys) {
+    hash.Set({key, "Zzlong", "Ivan", 1990, "Omsk", 1});
+    tree.Set({key, "Zzlong", "Ivan", 1990, "Omsk", 1});
+  }
+  for (const auto &key : keys) {
+    ASSERT_TRUE(hash.Exists(key));
+    ASSERT_TRUE(tree.Exists(key));
+  }
+  hash.Rename(keys[0], "short");
+  ASSERT_EQ(hash.Get("short")->key, "short");
+  ASSERT_TRUE(tree.Del(keys[1]));
+  ASSERT_EQ(tree.Keys().size(), 199);
+}
+
+#endif  // A6_COMPACT_KEY_TEST_H
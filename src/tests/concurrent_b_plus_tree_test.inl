@@ -0,0 +1,147 @@
+#ifndef A6_CONCURRENT_B_PLUS_TREE_TEST_H
+#define A6_CONCURRENT_B_PLUS_TREE_TEST_H
+#include <gtest/gtest.h>
+
+#include "../concurrent/concurrent_b_plus_tree.h"
+
+TEST(concurrent_b_plus_tree, ordered_operations) {
+  s21::ConcurrentBPlusTree storage;
+  std::mt19937 gen(7);
+  std::vector<int> order(5000);
+  for (int i = 0; i < 5000; ++i) order[i] = i;
+  std::shuffle(order.begin(), order.end(), gen);
+  for (int i : order) {
+    std::string key = std::to_string(i);
+    storage.Set({std::string(4 - key.size(), '0') + key, "Zzolc",
+                 i % 2 ? "Ivan" : "Petr", 1990, "Omsk", i});
+  }
+  ASSERT_EQ(storage.Size(), 5000);
+  auto keys = storage.Keys();
+  ASSERT_EQ(keys.size(), 5000);
+  ASSERT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+  ASSERT_EQ(storage.Keys(100, 3),
+            std::vector<std::string>({"0100", "0101", "0102"}));
+  ASSERT_EQ(storage.Scan("0998", "1001", 0),
+            std::vector<std::string>({"0998", "0999", "1000"}));
+  ASSERT_EQ(storage.Scan("0998", "1001", 0, true),
+            std::vector<std::string>({"1000", "0999", "0998"}));
+  ASSERT_EQ(storage.Scan("", "", 2, true),
+            std::vector<std::string>({"4999", "4998"}));
+  ASSERT_EQ(storage.ScanPrefix("012", 0).size(), 10);
+  ASSERT_EQ(storage.Find("Zzolc", "Ivan").size(), 2500);
+
+  storage.Update("0042", "", "", 0, "Kazan", 420);
+  Peer peer;
+  ASSERT_TRUE(storage.GetCopy("0042", &peer));
+  ASSERT_EQ(peer.city, "Kazan");
+  ASSERT_TRUE(storage.Expire("0042", 100));
+  storage.Rename("0042", "9999");
+  ASSERT_FALSE(storage.Exists("0042"));
+  ASSERT_GT(storage.PTTL("9999"), 0);
+  ASSERT_TRUE(storage.Persist("9999"));
+  ASSERT_EQ(storage.Scan("", "", 1, true), std::vector<std::string>({"9999"}));
+  for (int i = 0; i < 5000; i += 2) {
+    std::string key = std::to_string(i);
+    storage.Del(std::string(4 - key.size(), '0') + key);
+  }
+  ASSERT_EQ(storage.Size(), 2501);
+  ASSERT_EQ(storage.Scan("0040", "0046", 0),
+            std::vector<std::string>({"0041", "0043", "0045"}));
+
+  auto filename = RandStr(18);
+  ASSERT_EQ(storage.ExportData(filename), 2501);
+  s21::ConcurrentBPlusTree copy;
+  ASSERT_EQ(copy.Upload(filename), 2501);
+  ASSERT_EQ(copy.Keys(), storage.Keys());
+  std::remove(filename.c_str());
+}
+
+TEST(concurrent_b_plus_tree, scans_during_writes) {
+  s21::ConcurrentBPlusTree storage;
+  for (int i = 0; i < 2000; i += 2) {
+    std::string key = std::to_string(i);
+    storage.Set({std::string(4 - key.size(), '0') + key, "Zzolc", "Ivan",
+                 1990, "Omsk", i});
+  }
+  std::atomic<bool> done{false};
+  std::atomic<int> failures{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 2; ++t) {
+    readers.emplace_back([&storage, &done, &failures] {
+      while (!done.load()) {
+        auto keys = storage.Keys();
+        size_t stable = 0;
+        for (size_t i = 0; i < keys.size(); ++i) {
+          if (i && keys[i - 1] >= keys[i]) ++failures;
+          if (std::stoi(keys[i]) % 2 == 0) ++stable;
+        }
+        if (stable != 1000) ++failures;
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 2; ++t) {
+    writers.emplace_back([&storage, t] {
+      for (int round = 0; round < 5; ++round) {
+        for (int i = 1 + 2 * t; i < 2000; i += 4) {
+          std::string key = std::to_string(i);
+          key = std::string(4 - key.size(), '0') + key;
+          storage.Set({key, "Zzolc", "Petr", 1990, "Omsk", i});
+          storage.Update(key, "", "", 0, "", round);
+        }
+        for (int i = 1 + 2 * t; i < 2000; i += 4) {
+          std::string key = std::to_string(i);
+          storage.Del(std::string(4 - key.size(), '0') + key);
+        }
+      }
+    });
+  }
+  for (auto &writer : writers) writer.join();
+  done = true;
+  for (auto &reader : readers) reader.join();
+  ASSERT_EQ(failures.load(), 0);
+  ASSERT_EQ(storage.Size(), 1000);
+}
+
+TEST(concurrent_b_plus_tree, empty_leaves_unlinked) {
+  s21::ConcurrentBPlusTree storage;
+  auto name = [](int i) {
+    std::string key = std::to_string(i);
+    return std::string(5 - key.size(), '0') + key;
+  };
+  for (int i = 0; i < 20000; ++i)
+    storage.Set({name(i), "Zzprune", "Ivan", 1990, "Omsk", i});
+  std::atomic<bool> done{false};
+  std::atomic<int> failures{0};
+  std::thread reader([&] {
+    while (!done.load()) {
+      for (int i = 0; i < 20000; i += 500)
+        if (!storage.Exists(name(i))) ++failures;
+      auto keys = storage.Keys(0, 100);
+      for (size_t i = 1; i < keys.size(); ++i)
+        if (keys[i - 1] >= keys[i]) ++failures;
+    }
+  });
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 2; ++t) {
+    writers.emplace_back([&storage, &name, t] {
+      for (int i = t; i < 20000; i += 2)
+        if (i % 500) storage.Del(name(i));
+    });
+  }
+  for (auto &writer : writers) writer.join();
+  done = true;
+  reader.join();
+  ASSERT_EQ(failures.load(), 0);
+  ASSERT_EQ(storage.Size(), 40);
+  ASSERT_EQ(storage.Keys().size(), 40);
+  ASSERT_EQ(storage.Keys().back(), name(19500));
+  ASSERT_FALSE(storage.Persist(name(0)));
+  for (int i = 0; i < 20000; i += 3)
+    storage.Set({name(i), "Zzprune", "Petr", 1990, "Omsk", i}, 100);
+  ASSERT_EQ(storage.Keys().size(), 40 + 6667 - 14);
+  ASSERT_TRUE(storage.Persist(name(3)));
+  ASSERT_FALSE(storage.Persist(name(3)));
+}
+
+#endif  // A6_CONCURRENT_B_PLUS_TREE_TEST_H
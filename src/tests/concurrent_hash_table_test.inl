@@ -0,0 +1,132 @@
+#ifndef A6_CONCURRENT_HASH_TABLE_TEST_H
+#define A6_CONCURRENT_HASH_TABLE_TEST_H
+#include <gtest/gtest.h>
+
+#include "../concurrent/concurrent_hash_table.h"
+
+TEST(concurrent_hash_table, basic_operations_and_growth) {
+  s21::ConcurrentHashTable storage;
+  for (int i = 0; i < 5000; ++i) {
+    storage.Set({std::to_string(i), "Zzlockfree", i % 2 ? "Ivan" : "Petr",
+                 1990, "Omsk", i});
+  }
+  storage.Set({"7", "Other", "Other", 1, "Other", 0});
+  ASSERT_EQ(storage.Size(), 5000);
+  ASSERT_EQ(storage.Keys().size(), 5000);
+  ASSERT_EQ(storage.Find("Zzlockfree", "Ivan").size(), 2500);
+  ASSERT_EQ(storage.Get("7")->number_of_current_coins, 7);
+
+  storage.Update("7", "", "", 0, "Kazan", 70);
+  Peer peer;
+  ASSERT_TRUE(storage.GetCopy("7", &peer));
+  ASSERT_EQ(peer.city, "Kazan");
+  ASSERT_EQ(peer.number_of_current_coins, 70);
+
+  ASSERT_TRUE(storage.Expire("7", 100));
+  ASSERT_GT(storage.PTTL("7"), 0);
+  storage.Rename("7", "8");
+  ASSERT_FALSE(storage.Exists("7"));
+  ASSERT_EQ(storage.Get("8")->city, "Kazan");
+  ASSERT_GT(storage.TTL("8"), 0);
+  ASSERT_TRUE(storage.Persist("8"));
+  ASSERT_EQ(storage.PTTL("8"), -1);
+  ASSERT_EQ(storage.Size(), 4999);
+
+  ASSERT_TRUE(storage.Del("8"));
+  ASSERT_FALSE(storage.Del("8"));
+  ASSERT_FALSE(storage.GetCopy("8", &peer));
+  ASSERT_TRUE(storage.Expire("9", 0));
+  ASSERT_EQ(storage.PTTL("9"), -2);
+
+  auto filename = RandStr(18);
+  ASSERT_EQ(storage.ExportData(filename), 4997);
+  s21::ConcurrentHashTable copy;
+  ASSERT_EQ(copy.Upload(filename), 4997);
+  ASSERT_EQ(copy.Keys().size(), 4997);
+  std::remove(filename.c_str());
+}
+
+TEST(concurrent_hash_table, readers_during_writes) {
+  s21::ConcurrentHashTable storage;
+  for (int i = 0; i < 1000; ++i) {
+    storage.Set({std::to_string(i), "Zzreader", "Ivan", 1990, "Omsk", i});
+  }
+  std::atomic<bool> done{false};
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 3; ++t) {
+    readers.emplace_back([&] {
+      Peer peer;
+      while (!done.load()) {
+        for (int i = 0; i < 1000; ++i) {
+          std::string key = std::to_string(i);
+          if (storage.GetCopy(key, &peer) &&
+              peer.number_of_current_coins % 1000 != i)
+            ++mismatches;
+        }
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 2; ++t) {
+    writers.emplace_back([&storage, t] {
+      for (int round = 1; round <= 20; ++round) {
+        for (int i = t; i < 1000; i += 2) {
+          std::string key = std::to_string(i);
+          storage.Update(key, "", "", 0, "", round * 1000 + i);
+          if (i % 10 == 0) {
+            storage.Del(key);
+            storage.Set({key, "Zzreader", "Ivan", 1990, "Omsk", i});
+          }
+        }
+        for (int i = 0; i < 200; ++i) {
+          std::string key = std::to_string(t) + "_" + std::to_string(i);
+          storage.Set({key, "Zzreader", "Petr", 1990, "Omsk", 0}, 1);
+        }
+      }
+    });
+  }
+  for (auto &writer : writers) writer.join();
+  done = true;
+  for (auto &reader : readers) reader.join();
+  ASSERT_EQ(mismatches.load(), 0);
+  ASSERT_EQ(storage.Size(), 1400);
+  ASSERT_EQ(storage.Find("Zzreader", "Ivan").size(), 1000);
+}
+
+TEST(concurrent_hash_table, growth_keeps_keys_visible) {
+  s21::ConcurrentHashTable storage;
+  for (int i = 0; i < 1000; ++i) {
+    storage.Set({std::to_string(i), "Zzgrow", "Ivan", 1990, "Omsk", i});
+  }
+  std::atomic<bool> done{false};
+  std::atomic<int> misses{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 2; ++t) {
+    readers.emplace_back([&] {
+      while (!done.load()) {
+        for (int i = 0; i < 1000; ++i)
+          if (!storage.Exists(std::to_string(i))) ++misses;
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 2; ++t) {
+    writers.emplace_back([&storage, t] {
+      for (int i = 0; i < 20000; ++i) {
+        std::string key = std::to_string(t) + "_" + std::to_string(i);
+        storage.Set({key, "Zzgrow", "Petr", 1990, "Omsk", i});
+        storage.Update(std::to_string(i % 1000), "", "", 0, "", i);
+      }
+    });
+  }
+  for (auto &writer : writers) writer.join();
+  done = true;
+  for (auto &reader : readers) reader.join();
+  ASSERT_EQ(misses.load(), 0);
+  ASSERT_EQ(storage.Size(), 41000);
+  ASSERT_EQ(storage.Keys().size(), 41000);
+  ASSERT_EQ(storage.Find("Zzgrow", "Petr").size(), 40000);
+}
+
+#endif  // A6_CONCURRENT_HASH_TABLE_TEST_H
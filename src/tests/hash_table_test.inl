@@ -8,6 +8,89 @@
 #include "../hashtable/hash_table.h"
 #include "../tree/self_balancing_binary_search_tree.h"
 #include "tests.h"
+
+// Общие проверки Rename для всех хранилищ: запись переезжает вместе со
+// сроком жизни и индексами, занятый ключ заменяется.
+template <typename Storage>
+void CheckRenameMovesRecord() {
+  Storage storage;
+  storage.SetIndexing(true);
+  for (int i = 0; i < 200; ++i)
+    storage.Set({"k" + std::to_string(i), "Zzren", "Ivan", 1990, "Omsk", i});
+  storage.Set({"ttl", "Zzren", "Petr", 1991, "Omsk", 7}, 100);
+
+  storage.Rename("k5", "a5");
+  ASSERT_FALSE(storage.Exists("k5"));
+  ASSERT_EQ(storage.Get("a5")->number_of_current_coins, 5);
+  ASSERT_EQ(storage.Find("", "", 0, "", 5), std::vector<std::string>{"a5"});
+
+  storage.Rename("ttl", "k7");
+  ASSERT_FALSE(storage.Exists("ttl"));
+  ASSERT_EQ(storage.Get("k7")->first_name, "Petr");
+  ASSERT_GT(storage.PTTL("k7"), 0);
+  ASSERT_EQ(storage.Find("", "", 0, "", 7), std::vector<std::string>{"k7"});
+  ASSERT_EQ(storage.Find("", "Petr"), std::vector<std::string>{"k7"});
+  ASSERT_EQ(storage.Keys().size(), 200);
+
+  storage.Rename("k9", "k9");
+  ASSERT_TRUE(storage.Exists("k9"));
+  storage.Rename("missing", "k9");
+  ASSERT_TRUE(storage.Exists("k9"));
+  for (int i = 10; i < 200; ++i)
+    storage.Rename("k" + std::to_string(i), "z" + std::to_string(i));
+  for (int i = 10; i < 200; ++i) {
+    ASSERT_TRUE(storage.Exists("z" + std::to_string(i)));
+    ASSERT_FALSE(storage.Exists("k" + std::to_string(i)));
+  }
+  ASSERT_EQ(storage.Keys().size(), 200);
+  ASSERT_LE(storage.PTTL("k7"), 100000);
+}
+
+TEST(hash, rename_moves_record) { CheckRenameMovesRecord<s21::HashTable>(); }
+
+TEST(hash, rename_over_expiring_key) {
+  s21::HashTable storage;
+  storage.Set({"short", "a", "b", 1, "c", 1}, 1);
+  storage.Set({"long", "d", "e", 2, "f", 2});
+  storage.Rename("long", "short");
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  storage.ActiveExpireCycle();
+  ASSERT_TRUE(storage.Exists("short"));
+  ASSERT_EQ(storage.PTTL("short"), -1);
+}
+
+// Обход, разделённый на части, находит те же записи, что и
+// последовательный. Возвращает ключи параллельного обхода.
+template <typename Storage>
+auto CheckParallelScanMatchesSequential() -> std::vector<std::string> {
+  Storage storage;
+  for (int i = 0; i < 70000; ++i) {
+    storage.Set({"p" + std::to_string(i), "Zzpar", i % 3 ? "Ivan" : "Petr",
+                 1990, "Omsk", i});
+  }
+  storage.Expire("p42", 0);
+  EXPECT_TRUE(storage.SetParallelScan(1));
+  auto keys = storage.Keys();
+  auto found = storage.Find("", "Petr");
+  EXPECT_TRUE(storage.SetParallelScan(4));
+  auto parallel_keys = storage.Keys();
+  auto parallel_found = storage.Find("", "Petr");
+  EXPECT_EQ(storage.ShowAll().size(), 69999);
+  std::vector<std::string> result = parallel_keys;
+  std::sort(keys.begin(), keys.end());
+  std::sort(parallel_keys.begin(), parallel_keys.end());
+  std::sort(found.begin(), found.end());
+  std::sort(parallel_found.begin(), parallel_found.end());
+  EXPECT_EQ(parallel_keys, keys);
+  EXPECT_EQ(parallel_found, found);
+  EXPECT_EQ(found.size(), 23333);
+  return result;
+}
+
+TEST(hash, parallel_scan) {
+  CheckParallelScanMatchesSequential<s21::HashTable>();
+}
+
 TEST(hash, set_get) {
   s21::HashTable storage;
   for (int i = 0; i < 100; ++i) {
@@ -174,6 +257,20 @@ TEST(hash, ttl) {
   ASSERT_FALSE(storage.Exists("1"));
 }
 
+TEST(hash, active_expire_cycle) {
+  s21::HashTable storage;
+  storage.Set({"1", "1", "1", 1, "1", 1}, 1);
+  storage.Set({"1", "1", "1", 1, "1", 1}, 1);
+  storage.Set({"2", "1", "1", 1, "1", 1}, 1);
+  storage.Set({"21", "1", "1", 1, "1", 1}, 1);
+  storage.Set({"3", "1", "1", 1, "1", 1}, 1);
+  storage.Set({"4", "1", "1", 1, "1", 1});
+  std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+  ASSERT_EQ(storage.ActiveExpireCycle(), 4);
+  ASSERT_EQ(storage.ActiveExpireCycle(), 0);
+  ASSERT_EQ(storage.Keys(), std::vector<std::string>{"4"});
+}
+
 TEST(hash, rehash) {
   s21::HashTable storage;
   for (int i = 0; i < 10; ++i)
@@ -183,4 +280,129 @@ TEST(hash, rehash) {
   storage.Set({"1", "1", "1", 1, "1", 1});
 }
 
+TEST(hash, probing_with_tombstones) {
+  s21::HashTable storage;
+  for (int i = 0; i < 5000; ++i)
+    storage.Set({std::to_string(i), "a", "b", i, "c", i});
+  for (int i = 0; i < 5000; i += 2) ASSERT_TRUE(storage.Del(std::to_string(i)));
+  for (int i = 0; i < 5000; ++i) {
+    ASSERT_EQ(storage.Exists(std::to_string(i)), i % 2 == 1);
+  }
+  for (int i = 5000; i < 8000; ++i)
+    storage.Set({std::to_string(i), "a", "b", i, "c", i});
+  ASSERT_EQ(storage.Keys().size(), 5500);
+  ASSERT_EQ(storage.Get("7999")->year_of_birth, 7999);
+}
+
+TEST(hash, incremental_rehash) {
+  s21::HashTable storage;
+  for (int i = 0; i < 3000; ++i) {
+    storage.Set({std::to_string(i), "a", "b", i, "c", i});
+    if (i % 7 == 0) {
+      ASSERT_TRUE(storage.Del(std::to_string(i)));
+    }
+    ASSERT_EQ(storage.Exists(std::to_string(i / 2)), (i / 2) % 7 != 0);
+  }
+  while (storage.RehashStep()) {
+  }
+  for (int i = 0; i < 3000; ++i) {
+    ASSERT_EQ(storage.Exists(std::to_string(i)), i % 7 != 0);
+  }
+  ASSERT_EQ(storage.Keys().size(), 3000 - 429);
+}
+
+TEST(hash, reads_finish_rehash) {
+  s21::HashTable storage;
+  int count = 0;
+  while (!storage.RehashStep(0))
+    storage.Set({std::to_string(count++), "a", "b", 1, "c", 1});
+  for (int i = 0; i < count && storage.RehashStep(0); ++i)
+    ASSERT_NE(storage.Get(std::to_string(i)), nullptr);
+  ASSERT_FALSE(storage.RehashStep(0));
+}
+
+TEST(hash, expire_persist_pttl) {
+  s21::HashTable storage;
+  storage.Set({"a", "1", "1", 1, "1", 1});
+  storage.Set({"b", "1", "1", 1, "1", 1}, 100);
+  ASSERT_EQ(storage.PTTL("a"), -1);
+  ASSERT_EQ(storage.PTTL("missing"), -2);
+  ASSERT_GT(storage.PTTL("b"), 99000);
+  ASSERT_EQ(storage.TTL("b"), 100);
+  ASSERT_FALSE(storage.Expire("missing", 10));
+  ASSERT_TRUE(storage.Expire("a", 1));
+  ASSERT_EQ(storage.TTL("a"), 1);
+  ASSERT_TRUE(storage.Persist("b"));
+  ASSERT_FALSE(storage.Persist("b"));
+  ASSERT_EQ(storage.TTL("b"), 0);
+  storage.Rename("a", "c");
+  ASSERT_EQ(storage.TTL("c"), 1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  ASSERT_FALSE(storage.Exists("c"));
+  ASSERT_TRUE(storage.Exists("b"));
+  ASSERT_TRUE(storage.Expire("b", 0));
+  ASSERT_FALSE(storage.Exists("b"));
+}
+
+TEST(hash, indexed_find) {
+  s21::HashTable storage;
+  storage.Upload("1000.dat");
+  auto expected = storage.Find("", "", 1990, "Omsk");
+  auto by_name = storage.Find("", "Boris");
+  storage.SetIndexing(true);
+  auto indexed = storage.Find("", "", 1990, "Omsk");
+  std::sort(expected.begin(), expected.end());
+  std::sort(indexed.begin(), indexed.end());
+  ASSERT_EQ(indexed, expected);
+  ASSERT_EQ(storage.Find("", "Boris").size(), by_name.size());
+  ASSERT_EQ(storage.Find().size(), 1000);
+
+  storage.Set({"idx", "Zzindex", "Ivan", 1990, "Omsk", 5});
+  ASSERT_EQ(storage.Find("Zzindex", "Ivan", 1990, "Omsk", 5),
+            std::vector<std::string>{"idx"});
+  storage.Update("idx", "", "", 1991, "", 5);
+  ASSERT_TRUE(storage.Find("Zzindex", "Ivan", 1990).empty());
+  ASSERT_EQ(storage.Find("Zzindex", "", 1991).size(), 1);
+  storage.Rename("idx", "idx2");
+  ASSERT_EQ(storage.Find("Zzindex", "", 1991),
+            std::vector<std::string>{"idx2"});
+  storage.Del("idx2");
+  ASSERT_TRUE(storage.Find("Zzindex", "", 1991).empty());
+}
+
+TEST(hash, columnar_find) {
+  s21::HashTable storage;
+  storage.Upload("1000.dat");
+  auto expected = storage.Find("", "", 1985);
+  storage.SetColumnar(true);
+  auto scanned = storage.Find("", "", 1985);
+  std::sort(expected.begin(), expected.end());
+  std::sort(scanned.begin(), scanned.end());
+  ASSERT_EQ(scanned, expected);
+  ASSERT_TRUE(storage.Find("no_such_name").empty());
+
+  storage.Set({"col", "Zzcolumn", "Ivan", 1985, "Omsk", 7});
+  ASSERT_EQ(storage.Find("Zzcolumn", "", 1985, "Omsk"),
+            std::vector<std::string>{"col"});
+  storage.Update("col", "", "", 0, "Tomsk", 7);
+  ASSERT_TRUE(storage.Find("Zzcolumn", "", 0, "Omsk").empty());
+  ASSERT_TRUE(storage.Del("col"));
+  ASSERT_TRUE(storage.Find("Zzcolumn").empty());
+}
+
+TEST(hash, interned_fields) {
+  s21::HashTable storage;
+  storage.Set({"a", "Zzintern", "Ivan", 1990, "Omsk", 1});
+  storage.Set({"b", "Zzintern", "Petr", 1991, "Omsk", 2});
+  Peer *a = storage.Get("a");
+  Peer *b = storage.Get("b");
+  ASSERT_EQ(a->last_name.Id(), b->last_name.Id());
+  ASSERT_EQ(a->city.Id(), b->city.Id());
+  ASSERT_NE(a->first_name.Id(), b->first_name.Id());
+  ASSERT_EQ(static_cast<const std::string &>(b->first_name), "Petr");
+  size_t known = s21::StringDictionary::Instance().Size();
+  ASSERT_TRUE(storage.Find("Zznever_interned").empty());
+  ASSERT_EQ(s21::StringDictionary::Instance().Size(), known);
+}
+
 #endif  // A6_HASHTABLE_TEST_H
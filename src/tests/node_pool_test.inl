@@ -0,0 +1,39 @@
+#ifndef A6_NODE_POOL_TEST_H
+#define A6_NODE_POOL_TEST_H
+#include <gtest/gtest.h>
+
+#include "../other/node_pool.h"
+
+namespace {
+struct Counted {
+  explicit Counted(int *alive) : alive_(alive) { ++*alive_; }
+  ~Counted() { --*alive_; }
+  int *alive_;
+  char payload[100];
+};
+}  // namespace
+
+TEST(node_pool, reuse_and_bulk_clear) {
+  int alive = 0;
+  s21::NodePool<Counted> pool;
+  std::vector<Counted *> nodes;
+  for (int i = 0; i < 5000; ++i) nodes.push_back(pool.New(&alive));
+  ASSERT_EQ(alive, 5000);
+  ASSERT_EQ(pool.Size(), 5000);
+  ASSERT_EQ(reinterpret_cast<char *>(nodes[1]) -
+                reinterpret_cast<char *>(nodes[0]),
+            sizeof(Counted));
+
+  for (int i = 0; i < 5000; i += 2) pool.Delete(nodes[i]);
+  ASSERT_EQ(alive, 2500);
+  Counted *reused = pool.New(&alive);
+  ASSERT_EQ(reused, nodes[4998]);
+
+  pool.Clear();
+  ASSERT_EQ(alive, 0);
+  ASSERT_EQ(pool.Size(), 0);
+  pool.New(&alive);
+  ASSERT_EQ(alive, 1);
+}
+
+#endif  // A6_NODE_POOL_TEST_H
@@ -0,0 +1,71 @@
+#ifndef A6_RECORD_LOADER_TEST_H
+#define A6_RECORD_LOADER_TEST_H
+#include <gtest/gtest.h>
+
+#include "../other/record_loader.h"
+
+TEST(record_loader, chunks_follow_line_boundaries) {
+  auto filename = RandStr(18);
+  {
+    std::ofstream file(filename);
+    for (int i = 0; i < 150000; ++i) {
+      file << "key" << i << " Zzloader " << (i % 2 ? "Ivan" : "Petr") << " "
+           << 1900 + i % 100 << " Omsk " << i << "\n";
+      if (i == 777) file << "\n";
+    }
+  }
+  auto batches = s21::ParseRecords(filename, 4);
+  ASSERT_EQ(batches.size(), 4);
+  ASSERT_EQ(s21::RecordCount(batches), 150000);
+  int expected = 0;
+  for (const auto &batch : batches) {
+    ASSERT_FALSE(batch.empty());
+    for (const Peer &peer : batch) {
+      ASSERT_EQ(peer.key, "key" + std::to_string(expected));
+      ASSERT_EQ(peer.year_of_birth, 1900 + expected % 100);
+      ASSERT_EQ(peer.number_of_current_coins, expected);
+      ++expected;
+    }
+  }
+  ASSERT_EQ(batches[0][1].first_name, "Ivan");
+
+  s21::ShardedKeyValue sharded(
+      [] { return std::make_unique<s21::HashTable>(); }, 4, {});
+  ASSERT_EQ(sharded.Upload(filename), 150000);
+  ASSERT_EQ(sharded.Find("Zzloader", "Ivan").size(), 75000);
+  s21::SelfBalancingBinarySearchTree tree;
+  ASSERT_EQ(tree.Upload(filename), 150000);
+  ASSERT_EQ(tree.Get("key149999")->number_of_current_coins, 149999);
+  ASSERT_TRUE(s21::ParseRecords(filename + "missing").empty());
+  std::remove(filename.c_str());
+}
+
+TEST(record_loader, directory_is_not_a_file) {
+  auto directory = RandStr(18);
+  ASSERT_TRUE(std::filesystem::create_directory(directory));
+  ASSERT_TRUE(s21::ParseRecords(directory).empty());
+  s21::HashTable storage;
+  ASSERT_EQ(storage.Upload(directory), 0);
+  std::filesystem::remove(directory);
+}
+
+TEST(record_loader, last_line_without_newline) {
+  auto filename = RandStr(18);
+  {
+    std::ofstream file(filename);
+    file << "first Zzloader Ivan 1990 Omsk 1\n";
+    file << "tail Zzloader Petr 1991 Tomsk 2";
+  }
+  auto batches = s21::ParseRecords(filename);
+  ASSERT_EQ(s21::RecordCount(batches), 2);
+  const Peer &tail = batches.back().back();
+  ASSERT_EQ(tail.key, "tail");
+  ASSERT_EQ(tail.city, "Tomsk");
+  ASSERT_EQ(tail.number_of_current_coins, 2);
+  s21::HashTable storage;
+  ASSERT_EQ(storage.Upload(filename), 2);
+  ASSERT_EQ(storage.Get("tail")->first_name, "Petr");
+  std::remove(filename.c_str());
+}
+
+#endif  // A6_RECORD_LOADER_TEST_H
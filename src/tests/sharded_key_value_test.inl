@@ -0,0 +1,106 @@
+#ifndef A6_SHARDED_KEY_VALUE_TEST_H
+#define A6_SHARDED_KEY_VALUE_TEST_H
+#include <gtest/gtest.h>
+
+#include "../sharded/sharded_key_value.h"
+
+TEST(sharded, routes_and_merges) {
+  s21::ShardedKeyValue storage(
+      [] { return std::make_unique<s21::SelfBalancingBinarySearchTree>(); },
+      4);
+  for (int i = 0; i < 100; ++i) {
+    std::string key = std::to_string(i);
+    storage.Set({std::string(3 - key.size(), '0') + key, "Zzshard",
+                 i % 2 ? "Ivan" : "Petr", 1990, "Omsk", i});
+  }
+  auto keys = storage.Keys();
+  ASSERT_EQ(keys.size(), 100);
+  ASSERT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+  ASSERT_EQ(storage.Find("", "Ivan").size(), 50);
+  ASSERT_EQ(storage.Get("042")->number_of_current_coins, 42);
+
+  storage.Set({"ttl", "Zzshard", "Ivan", 1990, "Omsk", 0}, 100);
+  std::string name = "ttl";
+  for (int i = 0; i < 100; ++i) {
+    storage.Rename(name, "t" + std::to_string(i));
+    name = "t" + std::to_string(i);
+  }
+  ASSERT_FALSE(storage.Exists("ttl"));
+  ASSERT_FALSE(storage.Exists("t98"));
+  ASSERT_GT(storage.PTTL("t99"), 0);
+  storage.Rename("t99", "042");
+  ASSERT_EQ(storage.Get("042")->number_of_current_coins, 0);
+  ASSERT_EQ(storage.Keys().size(), 100);
+
+  auto filename = RandStr(18);
+  ASSERT_EQ(storage.ExportData(filename), 100);
+  s21::ShardedKeyValue copy(
+      [] { return std::make_unique<s21::HashTable>(); }, 3, {});
+  ASSERT_EQ(copy.Upload(filename), 100);
+  ASSERT_EQ(copy.Keys().size(), 100);
+  ASSERT_EQ(copy.Find("Zzshard", "Petr").size(), 49);
+  std::remove(filename.c_str());
+}
+
+TEST(sharded, rename_keeps_deadline) {
+  s21::ShardedKeyValue storage(
+      [] { return std::make_unique<s21::HashTable>(); }, 8);
+  storage.Set({"r", "Zzshard", "Ivan", 1990, "Omsk", 0}, 100);
+  int64_t deadline = storage.PExpireTime("r");
+  int64_t pttl = storage.PTTL("r");
+  ASSERT_GT(deadline, 0);
+  std::string name = "r";
+  for (int i = 0; i < 50; ++i) {
+    std::string next = "r" + std::to_string(i);
+    storage.Rename(name, next);
+    name = next;
+    ASSERT_EQ(storage.PExpireTime(name), deadline);
+    int64_t now_pttl = storage.PTTL(name);
+    ASSERT_LE(now_pttl, pttl);
+    pttl = now_pttl;
+  }
+  ASSERT_TRUE(storage.PExpireAt(name, 0));
+  ASSERT_EQ(storage.PTTL(name), -1);
+  ASSERT_TRUE(storage.PExpireAt(name, 1));
+  ASSERT_FALSE(storage.Exists(name));
+  ASSERT_EQ(storage.PExpireTime(name), -2);
+}
+
+TEST(sharded, concurrent_writers) {
+  s21::ShardedKeyValue storage(
+      [] { return std::make_unique<s21::HashTable>(); });
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&storage, t] {
+      for (int i = 0; i < 5000; ++i) {
+        std::string key = std::to_string(t) + "_" + std::to_string(i);
+        storage.Set({key, "Zzconc", "Ivan", 1990, "Omsk", i}, i % 10 ? 0 : 1);
+        if (i % 3 == 0) storage.Del(key);
+        storage.Exists(std::to_string((t + 1) % 4) + "_" + std::to_string(i));
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  ASSERT_EQ(storage.Keys().size(), 4 * (5000 - 1667));
+  std::this_thread::sleep_for(std::chrono::milliseconds(1300));
+  ASSERT_LT(storage.Keys().size(), 4 * (5000 - 1667));
+}
+
+TEST(sharded, results_outlive_expiry) {
+  s21::ShardedKeyValue storage(
+      [] { return std::make_unique<s21::SelfBalancingBinarySearchTree>(); }, 4,
+      std::chrono::milliseconds(10));
+  for (int i = 0; i < 50; ++i)
+    storage.Set({"k" + std::to_string(i), "Zzexp", "Ivan", 1990, "Omsk", i},
+                1);
+  Peer *peer = storage.Get("k7");
+  auto all = storage.ShowAll();
+  std::this_thread::sleep_for(std::chrono::milliseconds(1300));
+  ASSERT_TRUE(storage.Keys().empty());
+  ASSERT_EQ(peer->number_of_current_coins, 7);
+  ASSERT_EQ(all.size(), 50);
+  ASSERT_EQ(all.front()->key, "k0");
+  ASSERT_EQ(all.back()->last_name, "Zzexp");
+}
+
+#endif  // A6_SHARDED_KEY_VALUE_TEST_H
@@ -3,12 +3,24 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <cmath>
+#include <random>
+#include <set>
 #include <thread>
 
 #include "../hashtable/hash_table.h"
 #include "../tree/self_balancing_binary_search_tree.h"
 #include "hash_table_test.inl"
+#include "timing_wheel_test.inl"
+#include "column_store_test.inl"
+#include "compact_key_test.inl"
+#include "node_pool_test.inl"
+#include "b_plus_tree_test.inl"
 #include "tree_test.inl"
+#include "sharded_key_value_test.inl"
+#include "concurrent_hash_table_test.inl"
+#include "concurrent_b_plus_tree_test.inl"
+#include "record_loader_test.inl"
 
 void GenTable(const std::string& filename, int size) {
   std::vector<std::string> towns{
@@ -0,0 +1,74 @@
+#ifndef A6_TIMING_WHEEL_TEST_H
+#define A6_TIMING_WHEEL_TEST_H
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "../expiration/timing_wheel.h"
+
+TEST(timing_wheel, fires_only_due) {
+  s21::TimingWheel wheel(1000);
+  std::vector<std::string> fired;
+  auto collect = [&fired](const std::string &key, int64_t) {
+    fired.push_back(key);
+  };
+  wheel.Schedule("a", 1010);
+  wheel.Schedule("b", 1100);
+  wheel.Schedule("c", 6000);
+  ASSERT_EQ(wheel.Advance(1009, collect), 0);
+  ASSERT_EQ(wheel.Advance(1010, collect), 1);
+  ASSERT_EQ(fired.back(), "a");
+  ASSERT_EQ(wheel.Advance(5999, collect), 1);
+  ASSERT_EQ(fired.back(), "b");
+  ASSERT_EQ(wheel.Advance(6000, collect), 1);
+  ASSERT_EQ(fired.back(), "c");
+  ASSERT_TRUE(wheel.Empty());
+}
+
+TEST(timing_wheel, cascade_levels) {
+  s21::TimingWheel wheel(0);
+  std::set<std::string> fired;
+  auto collect = [&fired](const std::string &key, int64_t) {
+    fired.insert(key);
+  };
+  std::vector<int64_t> deadlines{63, 64, 4095, 4096, 262143, 300000, 90000000};
+  for (auto d : deadlines) wheel.Schedule(std::to_string(d), d);
+  for (auto d : deadlines) {
+    wheel.Advance(d - 1, collect);
+    ASSERT_EQ(fired.count(std::to_string(d)), 0);
+    wheel.Advance(d, collect);
+    ASSERT_EQ(fired.count(std::to_string(d)), 1);
+  }
+  ASSERT_EQ(fired.size(), deadlines.size());
+}
+
+TEST(timing_wheel, reports_deadline_of_each_reminder) {
+  s21::TimingWheel wheel(0);
+  std::vector<std::pair<std::string, int64_t>> fired;
+  auto collect = [&fired](const std::string &key, int64_t deadline) {
+    fired.emplace_back(key, deadline);
+  };
+  wheel.Schedule("a", 100);
+  wheel.Schedule("a", 5000);
+  ASSERT_EQ(wheel.Size(), 2);
+  ASSERT_EQ(wheel.Advance(4999, collect), 1);
+  ASSERT_EQ(fired.back(), std::make_pair(std::string("a"), int64_t{100}));
+  ASSERT_EQ(wheel.Advance(5000, collect), 1);
+  ASSERT_EQ(fired.back(), std::make_pair(std::string("a"), int64_t{5000}));
+  ASSERT_TRUE(wheel.Empty());
+}
+
+TEST(timing_wheel, bounded_advance_keeps_backlog) {
+  s21::TimingWheel wheel(0);
+  size_t fired = 0;
+  auto collect = [&fired](const std::string &, int64_t) { ++fired; };
+  for (int i = 0; i < 50; ++i) wheel.Schedule(std::to_string(i), 10 + i);
+  ASSERT_EQ(wheel.Advance(100, collect, 20), 20);
+  ASSERT_TRUE(wheel.HasDue());
+  ASSERT_EQ(wheel.Advance(100, collect, 20), 20);
+  ASSERT_EQ(wheel.Advance(100, collect, 20), 10);
+  ASSERT_FALSE(wheel.HasDue());
+  ASSERT_EQ(fired, 50);
+}
+
+#endif  // A6_TIMING_WHEEL_TEST_H
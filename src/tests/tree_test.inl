@@ -168,4 +168,270 @@ TEST(tree, ttl) {
   ASSERT_FALSE(storage.Exists("1"));
 }
 
+TEST(tree, active_expire_cycle) {
+  s21::SelfBalancingBinarySearchTree storage;
+  storage.Set({"1", "1", "1", 1, "1", 1}, 1);
+  storage.Set({"1", "1", "1", 1, "1", 1}, 1);
+  storage.Set({"2", "1", "1", 1, "1", 1}, 1);
+  storage.Set({"21", "1", "1", 1, "1", 1}, 1);
+  storage.Set({"3", "1", "1", 1, "1", 1}, 1);
+  storage.Set({"4", "1", "1", 1, "1", 1});
+  std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+  ASSERT_EQ(storage.ActiveExpireCycle(), 4);
+  ASSERT_EQ(storage.ActiveExpireCycle(), 0);
+  ASSERT_EQ(storage.Keys(), std::vector<std::string>{"4"});
+}
+
+TEST(tree, expire_persist_pttl) {
+  s21::SelfBalancingBinarySearchTree storage;
+  storage.Set({"a", "1", "1", 1, "1", 1});
+  storage.Set({"b", "1", "1", 1, "1", 1}, 100);
+  ASSERT_EQ(storage.PTTL("a"), -1);
+  ASSERT_EQ(storage.PTTL("missing"), -2);
+  ASSERT_GT(storage.PTTL("b"), 99000);
+  ASSERT_EQ(storage.TTL("b"), 100);
+  ASSERT_FALSE(storage.Expire("missing", 10));
+  ASSERT_TRUE(storage.Expire("a", 1));
+  ASSERT_EQ(storage.TTL("a"), 1);
+  ASSERT_TRUE(storage.Persist("b"));
+  ASSERT_FALSE(storage.Persist("b"));
+  ASSERT_EQ(storage.TTL("b"), 0);
+  storage.Rename("a", "c");
+  ASSERT_EQ(storage.TTL("c"), 1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  ASSERT_FALSE(storage.Exists("c"));
+  ASSERT_TRUE(storage.Exists("b"));
+  ASSERT_TRUE(storage.Expire("b", 0));
+  ASSERT_FALSE(storage.Exists("b"));
+}
+
+TEST(tree, indexed_find) {
+  s21::SelfBalancingBinarySearchTree storage;
+  storage.Upload("1000.dat");
+  auto expected = storage.Find("", "", 1990, "Omsk");
+  auto by_name = storage.Find("", "Boris");
+  storage.SetIndexing(true);
+  auto indexed = storage.Find("", "", 1990, "Omsk");
+  std::sort(expected.begin(), expected.end());
+  std::sort(indexed.begin(), indexed.end());
+  ASSERT_EQ(indexed, expected);
+  ASSERT_EQ(storage.Find("", "Boris").size(), by_name.size());
+  ASSERT_EQ(storage.Find().size(), 1000);
+
+  storage.Set({"idx", "Zzindex", "Ivan", 1990, "Omsk", 5});
+  ASSERT_EQ(storage.Find("Zzindex", "Ivan", 1990, "Omsk", 5),
+            std::vector<std::string>{"idx"});
+  storage.Update("idx", "", "", 1991, "", 5);
+  ASSERT_TRUE(storage.Find("Zzindex", "Ivan", 1990).empty());
+  ASSERT_EQ(storage.Find("Zzindex", "", 1991).size(), 1);
+  storage.Rename("idx", "idx2");
+  ASSERT_EQ(storage.Find("Zzindex", "", 1991),
+            std::vector<std::string>{"idx2"});
+  storage.Del("idx2");
+  ASSERT_TRUE(storage.Find("Zzindex", "", 1991).empty());
+}
+
+TEST(tree, columnar_find) {
+  s21::SelfBalancingBinarySearchTree storage;
+  storage.Upload("1000.dat");
+  auto expected = storage.Find("", "", 1985);
+  storage.SetColumnar(true);
+  auto scanned = storage.Find("", "", 1985);
+  std::sort(expected.begin(), expected.end());
+  std::sort(scanned.begin(), scanned.end());
+  ASSERT_EQ(scanned, expected);
+  ASSERT_TRUE(storage.Find("no_such_name").empty());
+
+  storage.Set({"col", "Zzcolumn", "Ivan", 1985, "Omsk", 7});
+  ASSERT_EQ(storage.Find("Zzcolumn", "", 1985, "Omsk"),
+            std::vector<std::string>{"col"});
+  storage.Update("col", "", "", 0, "Tomsk", 7);
+  ASSERT_TRUE(storage.Find("Zzcolumn", "", 0, "Omsk").empty());
+  ASSERT_TRUE(storage.Del("col"));
+  ASSERT_TRUE(storage.Find("Zzcolumn").empty());
+}
+
+TEST(tree, sequential_insert_and_erase) {
+  s21::SelfBalancingBinarySearchTree storage;
+  std::vector<std::string> keys;
+  for (int i = 0; i < 20000; ++i) {
+    std::string key = std::to_string(i);
+    keys.push_back(std::string(5 - key.size(), '0') + key);
+    storage.Set({keys.back(), "Zzseq", "Ivan", 1990, "Omsk", i});
+  }
+  for (size_t i = 0; i < keys.size(); i += 2) {
+    ASSERT_TRUE(storage.Del(keys[i]));
+  }
+  auto left = storage.Keys();
+  ASSERT_EQ(left.size(), keys.size() / 2);
+  ASSERT_TRUE(std::is_sorted(left.begin(), left.end()));
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(storage.Exists(keys[i]), i % 2 == 1);
+  }
+}
+
+TEST(tree, height_stays_logarithmic_under_churn) {
+  s21::SelfBalancingBinarySearchTree storage;
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> dist(0, 9999);
+  for (int i = 0; i < 100000; ++i) {
+    std::string key = std::to_string(dist(gen));
+    if (i % 3 == 2) {
+      storage.Del(key);
+    } else {
+      storage.Set({key, "Zzchurn", "Ivan", 1990, "Omsk", i});
+    }
+  }
+  Peer *kept = storage.Get(storage.Keys().front());
+  for (const auto &key : storage.Keys()) {
+    if (key != kept->key) storage.Del(key);
+  }
+  ASSERT_EQ(storage.Keys().size(), 1);
+  ASSERT_EQ(storage.Height(), 1);
+  for (int i = 0; i < 5000; ++i) {
+    storage.Set({std::to_string(i), "Zzchurn", "Ivan", 1990, "Omsk", i});
+    if (i % 2) storage.Del(std::to_string(i / 2));
+  }
+  double n = static_cast<double>(storage.Keys().size());
+  ASSERT_LE(storage.Height(), 1.44 * std::log2(n + 2));
+}
+
+TEST(tree, ordered_scan) {
+  s21::SelfBalancingBinarySearchTree storage;
+  for (int i = 0; i < 300; ++i) {
+    std::string key = std::to_string(i);
+    storage.Set({"k" + std::string(3 - key.size(), '0') + key, "Zzscan",
+                 "Ivan", 1990, "Omsk", i});
+  }
+  storage.Set({"a", "Zzscan", "Ivan", 1990, "Omsk", 0});
+  storage.Set({"z", "Zzscan", "Ivan", 1990, "Omsk", 0});
+
+  using Keys = std::vector<std::string>;
+  ASSERT_EQ(storage.Scan("k010", "k013", 0), (Keys{"k010", "k011", "k012"}));
+  ASSERT_EQ(storage.Scan("k0105", "k013", 0), (Keys{"k011", "k012"}));
+  ASSERT_EQ(storage.Scan("k010", "k013", 0, true),
+            (Keys{"k012", "k011", "k010"}));
+  ASSERT_EQ(storage.Scan("", "", 2), (Keys{"a", "k000"}));
+  ASSERT_EQ(storage.Scan("", "", 2, true), (Keys{"z", "k299"}));
+  ASSERT_EQ(storage.ScanPrefix("k", 0).size(), 300);
+  ASSERT_EQ(storage.ScanPrefix("k29", 3, true),
+            (Keys{"k299", "k298", "k297"}));
+  ASSERT_TRUE(storage.ScanPrefix("x", 0).empty());
+  ASSERT_TRUE(storage.Scan("k200", "k100", 0).empty());
+
+  ASSERT_TRUE(storage.Expire("k011", 0));
+  ASSERT_EQ(storage.Scan("k010", "k013", 0), (Keys{"k010", "k012"}));
+  ASSERT_EQ(s21::SelfBalancingBinarySearchTree::PrefixEnd("ab"), "ac");
+}
+
+TEST(tree, order_statistics) {
+  s21::SelfBalancingBinarySearchTree storage;
+  std::set<std::string> reference;
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<int> dist(0, 1999);
+  for (int i = 0; i < 20000; ++i) {
+    std::string key = std::to_string(dist(gen));
+    if (i % 3 == 2) {
+      storage.Del(key);
+      reference.erase(key);
+    } else {
+      storage.Set({key, "Zzrank", "Ivan", 1990, "Omsk", i});
+      reference.insert(key);
+    }
+  }
+  std::vector<std::string> sorted(reference.begin(), reference.end());
+  for (size_t i = 0; i < sorted.size(); i += 7) {
+    ASSERT_EQ(storage.Rank(sorted[i]), i);
+    ASSERT_EQ(storage.Select(i)->key, sorted[i]);
+  }
+  ASSERT_EQ(storage.Select(sorted.size()), nullptr);
+  ASSERT_EQ(storage.Rank("~"), sorted.size());
+  ASSERT_EQ(storage.CountRange("", ""), sorted.size());
+  auto first = std::lower_bound(sorted.begin(), sorted.end(), "3");
+  auto last = std::lower_bound(sorted.begin(), sorted.end(), "5");
+  ASSERT_EQ(storage.CountRange("3", "5"),
+            static_cast<size_t>(last - first));
+  ASSERT_EQ(storage.CountRange("5", "3"), 0);
+
+  auto page = storage.Keys(100, 50);
+  ASSERT_EQ(page, std::vector<std::string>(sorted.begin() + 100,
+                                           sorted.begin() + 150));
+  ASSERT_EQ(storage.Keys(sorted.size() - 3, 50).size(), 3);
+  ASSERT_EQ(storage.Keys(0, 0).size(), sorted.size());
+  ASSERT_EQ(storage.Keys(), sorted);
+  ASSERT_EQ(storage.Scan("", "", 0, true),
+            std::vector<std::string>(sorted.rbegin(), sorted.rend()));
+}
+
+TEST(tree, order_statistics_skip_expired) {
+  s21::SelfBalancingBinarySearchTree storage;
+  for (int i = 0; i < 100; ++i) {
+    std::string key = std::to_string(100 + i);
+    storage.Set({key, "Zzrank", "Ivan", 1990, "Omsk", i}, i % 2 ? 0 : 1);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  ASSERT_EQ(storage.Rank("150"), 25);
+  ASSERT_EQ(storage.Select(0)->key, "101");
+  ASSERT_EQ(storage.Select(49)->key, "199");
+  ASSERT_EQ(storage.Select(50), nullptr);
+  ASSERT_EQ(storage.CountRange("", ""), 50);
+  ASSERT_EQ(storage.Keys(10, 2), (std::vector<std::string>{"121", "123"}));
+}
+
+TEST(tree, bulk_upload) {
+  auto filename = RandStr(18);
+  {
+    std::ofstream file(filename);
+    for (int i : {5, 3, 9, 3, 1, 7}) {
+      file << "k" << i << " Zzbulk Ivan 1990 Omsk " << i * 10
+           << (i == 3 ? 1 : 0) << "\n";
+    }
+  }
+  s21::SelfBalancingBinarySearchTree shuffled;
+  ASSERT_EQ(shuffled.Upload(filename), 6);
+  using Keys = std::vector<std::string>;
+  ASSERT_EQ(shuffled.Keys(), (Keys{"k1", "k3", "k5", "k7", "k9"}));
+  ASSERT_EQ(shuffled.Get("k3")->number_of_current_coins, 301);
+  ASSERT_EQ(shuffled.Rank("k7"), 3);
+  ASSERT_EQ(shuffled.Height(), 3);
+
+  s21::SelfBalancingBinarySearchTree source;
+  for (int i = 0; i < 5000; ++i)
+    source.Set({std::to_string(i), "Zzbulk", "Ivan", 1990, "Omsk", i});
+  source.ExportData(filename);
+  s21::SelfBalancingBinarySearchTree loaded;
+  loaded.SetIndexing(true);
+  ASSERT_EQ(loaded.Upload(filename), 5000);
+  ASSERT_EQ(loaded.Keys(), source.Keys());
+  ASSERT_EQ(loaded.Height(), 13);
+  ASSERT_EQ(loaded.Find("", "", 0, "", 4321), Keys{"4321"});
+  loaded.Set({"zz", "Zzbulk", "Ivan", 1990, "Omsk", 0});
+  ASSERT_TRUE(loaded.Del("2500"));
+  ASSERT_EQ(loaded.Keys().size(), 5000);
+  ASSERT_EQ(loaded.Upload(filename), 5000);
+  ASSERT_EQ(loaded.Keys().size(), 5001);
+  std::remove(filename.c_str());
+}
+
+TEST(tree, rename_moves_record) {
+  CheckRenameMovesRecord<s21::SelfBalancingBinarySearchTree>();
+  s21::SelfBalancingBinarySearchTree storage;
+  for (int i = 0; i < 1000; ++i)
+    storage.Set({std::to_string(i), "Zzren", "Ivan", 1990, "Omsk", i});
+  for (int i = 0; i < 1000; i += 3)
+    storage.Rename(std::to_string(i), "r" + std::to_string(i));
+  auto keys = storage.Keys();
+  ASSERT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+  ASSERT_EQ(keys.size(), 1000);
+  ASSERT_EQ(storage.Rank("r"), 666);
+  ASSERT_LE(storage.Height(), 1.44 * std::log2(1002.0));
+}
+
+TEST(tree, parallel_scan_keeps_key_order) {
+  auto keys =
+      CheckParallelScanMatchesSequential<s21::SelfBalancingBinarySearchTree>();
+  ASSERT_EQ(keys.size(), 69999);
+  ASSERT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+}
+
 #endif  // A6_TREE_TEST_H
@@ -3,16 +3,20 @@
 
 #include <math.h>
 
-#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <limits>
-#include <list>
 
+#include "../expiration/expirer.h"
+#include "../index/column_store.h"
+#include "../index/secondary_index.h"
 #include "../other/key_value.h"
+#include "../other/node_pool.h"
+#include "../other/ordered_key_value.h"
+#include "../other/worker_pool.h"
 
 namespace s21 {
-class SelfBalancingBinarySearchTree : public KeyValue {
+class SelfBalancingBinarySearchTree : public OrderedKeyValue {
  public:
   SelfBalancingBinarySearchTree() = default;
   ~SelfBalancingBinarySearchTree() override { clear(); }
@@ -25,7 +29,7 @@ class SelfBalancingBinarySearchTree : public KeyValue {
   /// @param city
   /// @param number_of_current_coins
   /// @param time_of_life
-  auto Set(const Peer &peer, int time_of_life = 0) -> void override;
+  auto Set(Peer peer, int time_of_life = 0) -> void override;
 
   /// @brief Команда используется для получения значения, связанного с ключом.
   /// @param key
@@ -73,6 +77,33 @@ class SelfBalancingBinarySearchTree : public KeyValue {
   /// @return Если записи с заданным ключом не существует, то возвращается 0
   auto TTL(const std::string &key) -> int override;
 
+  /// @brief Устанавливает время жизни существующего ключа, не меняя значения.
+  /// @param key
+  /// @param seconds если не больше 0, ключ удаляется сразу
+  /// @return Возвращает false, если ключа нет
+  auto Expire(const std::string &key, int seconds) -> bool override;
+
+  /// @brief Снимает ограничение времени жизни ключа.
+  /// @param key
+  /// @return Возвращает true, если у ключа было время жизни
+  auto Persist(const std::string &key) -> bool override;
+
+  /// @brief Оставшееся время жизни ключа в миллисекундах.
+  /// @param key
+  /// @return -2, если ключа нет, и -1, если время жизни не ограничено
+  auto PTTL(const std::string &key) -> int64_t override;
+
+  /// @brief Срок истечения ключа в миллисекундах по часам Expirer::NowMs.
+  /// @param key
+  /// @return -2, если ключа нет, и -1, если время жизни не ограничено
+  auto PExpireTime(const std::string &key) -> int64_t override;
+
+  /// @brief Устанавливает абсолютный срок истечения существующего ключа.
+  /// @param key
+  /// @param deadline 0 - без ограничения; наступивший срок удаляет ключ
+  /// @return Возвращает false, если ключа нет
+  auto PExpireAt(const std::string &key, int64_t deadline) -> bool override;
+
   /// @brief Эта команда используется для восстановления ключа (или ключей) по
   /// заданному значению.
   /// @param last_name
@@ -86,11 +117,77 @@ class SelfBalancingBinarySearchTree : public KeyValue {
             const std::string &city = "", int number_of_current_coins = -1)
       -> std::vector<std::string> override;
 
+  /// @brief Включает или выключает вторичные индексы по полям значения,
+  /// ускоряющие Find. При включении индексы строятся по текущим данным.
+  /// @param enable
+  /// @return true
+  auto SetIndexing(bool enable) -> bool override;
+
+  /// @brief Включает или выключает колоночную копию полей значения, по
+  /// которой Find без индексов выполняется векторным сканированием.
+  /// @param enable
+  /// @return true
+  auto SetColumnar(bool enable) -> bool override;
+
+  /// @brief Полный обход делится на отрезки равной длины по номерам
+  /// узлов; отрезки следуют по порядку ключей, поэтому результат остаётся
+  /// отсортированным.
+  /// @param parts
+  /// @return true
+  auto SetParallelScan(size_t parts) -> bool override;
+
   /// @brief Команда для получения всех записей, которые содержатся в key-value
   /// хранилище на текущий момент
   /// @return
   auto ShowAll() -> std::vector<Peer *> override;
 
+  /// @brief Цикл активного удаления истёкших ключей. Хранилище запускает его
+  /// само по ходу операций, но его можно вызывать и в периоды простоя.
+  /// @param budget ограничение времени работы цикла
+  /// @return Число удалённых записей
+  auto ActiveExpireCycle(
+      std::chrono::microseconds budget = std::chrono::milliseconds(1))
+      -> size_t override;
+
+  /// @brief Обходит записи с ключами из [from, to) в порядке ключей.
+  /// Начало диапазона находится спуском по дереву за O(log n).
+  /// @param from пустая строка - от наименьшего ключа
+  /// @param to пустая строка - до наибольшего ключа включительно
+  /// @param visit
+  /// @param reverse обход по убыванию ключей
+  auto ScanRange(const std::string &from, const std::string &to,
+                 const Visitor &visit, bool reverse = false) -> void override;
+
+  /// @brief Страница ключей по порядку: узел с номером offset находится
+  /// спуском по размерам поддеревьев за O(log n), остальные берутся по
+  /// порядку.
+  /// @param offset
+  /// @param limit 0 - до конца
+  /// @return
+  auto Keys(size_t offset, size_t limit) -> std::vector<std::string> override;
+
+  /// @brief Число записей с ключом меньше key, за O(log n). Перед подсчётом
+  /// здесь, в Select, CountRange и Keys(offset, limit) удаляются все
+  /// записи, срок которых уже наступил, поэтому номера считаются только по
+  /// живым записям.
+  /// @param key
+  /// @return
+  auto Rank(const std::string &key) -> size_t;
+
+  /// @brief Запись с номером index в порядке ключей, за O(log n).
+  /// @param index
+  /// @return nullptr, если index не меньше числа записей
+  auto Select(size_t index) -> Peer *;
+
+  /// @brief Число записей с ключами из [from, to), за O(log n).
+  /// @param from пустая строка - от наименьшего ключа
+  /// @param to пустая строка - до наибольшего ключа включительно
+  /// @return
+  auto CountRange(const std::string &from, const std::string &to) -> size_t;
+
+  /// @brief Высота дерева; 0 для пустого хранилища.
+  auto Height() const -> int { return Height(head_node_); }
+
   /// @brief Данная команда используется для загрузки данных из файла.
   /// @param data_directory
   /// @return Выводится число загруженных строк из файла.
@@ -103,45 +200,45 @@ class SelfBalancingBinarySearchTree : public KeyValue {
   auto ExportData(const std::string &data_directory) -> int override;
 
  private:
+  /// Меньше записей на часть обход не делит: запуск части дороже.
+  static constexpr size_t kMinScanPart = 1 << 14;
+
   class Node {
    public:
     Peer kV_;
     Node *p_parent_;
     Node *p_right_;
     Node *p_left_;
+    Node *p_prev_{nullptr};
+    Node *p_next_{nullptr};
     int balance_;
-    int right_deph_;
-    int left_deph_;
+    int height_;
+    size_t count_;
+    int64_t deadline_{0};
 
-    explicit Node(const Peer &kV, Node *pParent = nullptr,
-                  Node *pRight = nullptr, Node *pLeft = nullptr)
-        : kV_(kV),
+    explicit Node(Peer kV, Node *pParent = nullptr, Node *pRight = nullptr,
+                  Node *pLeft = nullptr)
+        : kV_(std::move(kV)),
           p_parent_(pParent),
           p_right_(pRight),
           p_left_(pLeft),
           balance_(0),
-          right_deph_(0),
-          left_deph_(0) {}
+          height_(1),
+          count_(1) {}
   };
 
   class SetIterator {
    public:
-    Node *_parent;
     Node *_current;
 
-    SetIterator() : _parent(nullptr), _current(nullptr) {}
-
-    SetIterator(const SetIterator &other)
-        : _parent(other._parent), _current(other._current) {}
+    SetIterator() : _current(nullptr) {}
 
-    explicit SetIterator(const SelfBalancingBinarySearchTree &map)
-        : _parent(nullptr), _current(map.head_node_) {}
+    explicit SetIterator(Node *node) : _current(node) {}
 
     SetIterator &operator++();
     SetIterator &operator--();
-    Peer operator*();
+    Peer &operator*();
     bool operator!=(const SetIterator &other);
-    void ChangeIterPos(Node *other);
   };
 
   using iterator = SetIterator;
@@ -151,30 +248,54 @@ class SelfBalancingBinarySearchTree : public KeyValue {
   size_t MaxSize();
   void clear();
   void Erase(Node *node);
+  void Detach(Node *node);
+  void Attach(Node *node, Node *parent, Node **link);
 
-  auto UpdateTimer() -> void;
+  auto Reclaim(const std::string &key, int64_t deadline) -> bool;
+  auto Tick() -> void;
+  auto ReclaimDue() -> void;
+  auto Track(const Peer &peer) -> void;
+  auto Untrack(const Peer &peer) -> void;
+  template <typename Func>
+  void ForEach(Func func);
+  template <typename T, typename Func>
+  auto Collect(Func func) -> std::vector<T>;
+  auto SetDeadline(Node *node, int64_t deadline) -> void;
 
-  enum class Left_Right { left, right };
   Node *FindNode(const std::string &key);
-  void ClearDeep(Node *&node);
+  Node *FindLiveNode(const std::string &key);
   void Balancing(Node *node);
   void ChangeBalanceToCurrentNode(Node *curNode);
-  int MaxDepth(Node *node);
-  void AddNode(Node *node, Peer a, iterator &it);
+  static int Height(const Node *node) { return node ? node->height_ : 0; }
+  static size_t Count(const Node *node) { return node ? node->count_ : 0; }
+  size_t RankOf(const std::string &key) const;
+  Node *SelectNode(size_t index) const;
+  Node **FindLink(std::string_view key, Node **parent);
+  Node *InsertNode(Peer &&peer);
+  Node *LowerBound(const std::string &key) const;
+  Node *LastBefore(const std::string &key) const;
+  void BulkLoad(std::vector<Peer> &&peers);
+  Node *Build(Node **nodes, size_t count, Node *parent);
+  void Link(Node *node, Node *prev, Node *next);
+  void Unlink(Node *node);
   void LeftTurn(Node *node);
   void RightTurn(Node *node);
   void BigLeftTurn(Node *node);
   void BigRightTurn(Node *node);
-  void EraseHead(Node *node);
-  void EraseLeftOrRightParents(Node *node);
-  Node *Cycle(Node *node_cycle, Left_Right pos);
-  void FindLastNode(Node *node);
+  void ReplaceChild(Node *parent, Node *old_child, Node *new_child);
 
+  NodePool<Node> nodes_;
   Node *head_node_{nullptr};
+  Node *first_node_{nullptr};
+  Node *last_node_{nullptr};
   size_t size_{0};
 
-  std::list<std::pair<Node *, time_t>> timer_;
-  std::chrono::system_clock::time_point old_time_;
+  Expirer expiry_;
+  SecondaryIndex index_;
+  ColumnStore columns_;
+  bool indexing_ = false;
+  bool columnar_ = false;
+  size_t scan_parts_ = WorkerCount();
 };
 }  //  namespace s21
 #endif  // A6_SELF_BALANCING_BINARY_SEARCH_TREE_H
@@ -1,38 +1,22 @@
 #include "self_balancing_binary_search_tree.h"
+
+#include <algorithm>
+
 namespace s21 {
 
 //  SelfBalancingBinarySearchTree
 //  Iterators-------------------------------------------------
 
+// Узлы связаны в список по порядку ключей, поэтому begin и end берутся
+// за O(1), а переход к соседнему узлу - один переход по указателю.
 typename SelfBalancingBinarySearchTree::iterator
 SelfBalancingBinarySearchTree::begin() {
-  iterator it(*this);
-  if (head_node_ != nullptr) {
-    while (it._parent != nullptr) {
-      it._current = it._parent;
-    }
-    while (it._current->p_left_ != nullptr) {
-      it._current = it._current->p_left_;
-    }
-    it._parent = it._current->p_parent_;
-  }
-  return it;
+  return iterator(first_node_);
 }
 
 typename SelfBalancingBinarySearchTree::iterator
 SelfBalancingBinarySearchTree::end() {
-  iterator it(*this);
-  if (head_node_ != nullptr) {
-    while (it._parent != nullptr) {
-      it._current = it._parent;
-    }
-    while (it._current->p_right_ != nullptr) {
-      it._current = it._current->p_right_;
-    }
-    it._parent = it._current;
-    it._current = it._current->p_right_;
-  }
-  return it;
+  return iterator(nullptr);
 }
 
 size_t SelfBalancingBinarySearchTree::MaxSize() {
@@ -44,205 +28,144 @@ size_t SelfBalancingBinarySearchTree::MaxSize() {
 //  SelfBalancingBinarySearchTree
 //  Modifiers--------------------------------------------
 
+// Узлы лежат в пуле, поэтому дерево не обходится: пул уничтожает записи
+// подряд по плитам и возвращает память целиком.
 void SelfBalancingBinarySearchTree::clear() {
-  if (head_node_ != nullptr) {
-    ClearDeep(head_node_);
-  }
+  nodes_.Clear();
+  head_node_ = first_node_ = last_node_ = nullptr;
+  size_ = 0;
 }
 
-void SelfBalancingBinarySearchTree::ClearDeep(Node*& node) {
-  if (node->p_right_ != nullptr) {
-    ClearDeep(node->p_right_);
-  }
-  if (node->p_left_ != nullptr) {
-    ClearDeep(node->p_left_);
+// Ставит new_child на место old_child у parent (или в корень).
+void SelfBalancingBinarySearchTree::ReplaceChild(Node* parent, Node* old_child,
+                                                 Node* new_child) {
+  if (parent == nullptr) {
+    head_node_ = new_child;
+  } else if (parent->p_left_ == old_child) {
+    parent->p_left_ = new_child;
+  } else {
+    parent->p_right_ = new_child;
   }
-  if (node) {
-    delete node;
-    node = nullptr;
-    --size_;
+  if (new_child != nullptr) {
+    new_child->p_parent_ = parent;
   }
 }
 
-void SelfBalancingBinarySearchTree::EraseHead(Node* node) {
-  if (node->p_right_ != nullptr) {
-    node->p_right_->p_parent_ = nullptr;
-    head_node_ = node->p_right_;
-    Node* buf = node->p_right_;
-    while (buf->p_left_ != nullptr) {
-      buf = buf->p_left_;
-    }
-    if (node->p_left_ != nullptr) {
-      node->p_left_->p_parent_ = buf;
-      buf->p_left_ = node->p_left_;
-    }
-  } else {
-    if (node->p_left_ != nullptr) {
-      node->p_left_->p_parent_ = nullptr;
-      head_node_ = node->p_left_;
-    }
+// Строит идеально сбалансированное дерево из записей за O(n). Данные,
+// выгруженные ExportData, уже упорядочены и проверяются одним проходом;
+// иначе записи сортируются. Из записей с одинаковым ключом остаётся
+// первая, как при последовательных вызовах Set. Дерево должно быть пустым.
+void SelfBalancingBinarySearchTree::BulkLoad(std::vector<Peer>&& peers) {
+  auto less = [](const Peer& a, const Peer& b) { return a.key < b.key; };
+  auto equal = [](const Peer& a, const Peer& b) { return a.key == b.key; };
+  auto unordered = [](const Peer& a, const Peer& b) {
+    return !(a.key < b.key);
+  };
+  if (std::adjacent_find(peers.begin(), peers.end(), unordered) !=
+      peers.end()) {
+    std::stable_sort(peers.begin(), peers.end(), less);
+    peers.erase(std::unique(peers.begin(), peers.end(), equal), peers.end());
   }
-  delete (node);
-  --size_;
-  if (!size_) head_node_ = nullptr;
-  Balancing(head_node_);
+  std::vector<Node*> nodes;
+  nodes.reserve(peers.size());
+  for (Peer& peer : peers) {
+    nodes.push_back(nodes_.New(std::move(peer)));
+    Link(nodes.back(), last_node_, nullptr);
+    Track(nodes.back()->kV_);
+  }
+  head_node_ = Build(nodes.data(), nodes.size(), nullptr);
+  size_ = nodes.size();
 }
 
-void SelfBalancingBinarySearchTree::EraseLeftOrRightParents(Node* node) {
-  if (node->p_parent_ != nullptr) {
-    if (node == node->p_parent_->p_right_) {
-      if (node->p_right_ != nullptr) {
-        node->p_parent_->p_right_ = node->p_right_;
-        FindLastNode(node);
-      } else if (node->p_left_ != nullptr) {
-        node->p_left_->p_parent_ = node->p_parent_;
-        node->p_parent_->p_right_ = node->p_left_;
-      } else {
-        node->p_parent_->p_right_ = nullptr;
-      }
-    } else if (node == node->p_parent_->p_left_) {
-      if (node->p_right_ != nullptr) {
-        node->p_parent_->p_left_ = node->p_right_;
-        FindLastNode(node);
-      } else if (node->p_left_ != nullptr) {
-        node->p_left_->p_parent_ = node->p_parent_;
-        node->p_parent_->p_left_ = node->p_left_;
-      } else {
-        node->p_parent_->p_left_ = nullptr;
-      }
-    }
-    delete (node);
-    --size_;
-    Balancing(head_node_);
-  }
+// Середина отрезка становится корнем поддерева, половины - его детьми.
+typename SelfBalancingBinarySearchTree::Node*
+SelfBalancingBinarySearchTree::Build(Node** nodes, size_t count,
+                                     Node* parent) {
+  if (count == 0) return nullptr;
+  size_t middle = count / 2;
+  Node* node = nodes[middle];
+  node->p_parent_ = parent;
+  node->p_left_ = Build(nodes, middle, node);
+  node->p_right_ = Build(nodes + middle + 1, count - middle - 1, node);
+  ChangeBalanceToCurrentNode(node);
+  return node;
 }
 
-void SelfBalancingBinarySearchTree::FindLastNode(Node* node) {
-  node->p_right_->p_parent_ = node->p_parent_;
-  if (node->p_left_ != nullptr) {
-    Node* buf_c = Cycle(node->p_right_, Left_Right::left);
-    node->p_left_->p_parent_ = buf_c;
-    buf_c->p_left_ = node->p_left_;
+// Вставляет node в список узлов между prev и next.
+void SelfBalancingBinarySearchTree::Link(Node* node, Node* prev, Node* next) {
+  node->p_prev_ = prev;
+  node->p_next_ = next;
+  if (prev != nullptr) {
+    prev->p_next_ = node;
+  } else {
+    first_node_ = node;
+  }
+  if (next != nullptr) {
+    next->p_prev_ = node;
+  } else {
+    last_node_ = node;
   }
 }
 
-typename SelfBalancingBinarySearchTree::Node*
-SelfBalancingBinarySearchTree::Cycle(Node* node_cycle, Left_Right pos) {
-  if (node_cycle != nullptr) {
-    if (pos == Left_Right::right) {
-      while (node_cycle->p_right_ != nullptr) {
-        node_cycle = node_cycle->p_right_;
-      }
-    }
-    if (pos == Left_Right::left) {
-      while (node_cycle->p_left_ != nullptr) {
-        node_cycle = node_cycle->p_left_;
-      }
-    }
+void SelfBalancingBinarySearchTree::Unlink(Node* node) {
+  if (node->p_prev_ != nullptr) {
+    node->p_prev_->p_next_ = node->p_next_;
+  } else {
+    first_node_ = node->p_next_;
+  }
+  if (node->p_next_ != nullptr) {
+    node->p_next_->p_prev_ = node->p_prev_;
+  } else {
+    last_node_ = node->p_prev_;
   }
-  return node_cycle;
 }
 
 typename SelfBalancingBinarySearchTree::SetIterator&
 SelfBalancingBinarySearchTree::iterator::operator++() {
-  if (_parent == nullptr && _current == nullptr) {
+  if (_current == nullptr) {
     throw std::invalid_argument("operator++ all is nullptr");
   }
-  if (_parent != nullptr) {
-    if (_current == nullptr) {
-      _current = _parent;
-      _parent = _current->p_parent_;
-    } else if (_parent->p_left_ == _current && _current->p_right_ == nullptr) {
-      _current = _parent;
-      _parent = _parent->p_parent_;
-    } else if (_current->p_right_ != nullptr) {
-      _current = _current->p_right_;
-      while (_current->p_left_ != nullptr) {
-        _current = _current->p_left_;
-      }
-      _parent = _current->p_parent_;
-    } else {
-      while (_current->p_parent_ != nullptr &&
-             _current != _current->p_parent_->p_left_) {
-        _current = _current->p_parent_;
-      }
-      if (_current->p_parent_ == nullptr) {
-        _current = nullptr;
-        _parent = _parent->p_right_;
-      } else {
-        _current = _current->p_parent_;
-        _parent = _current->p_parent_;
-      }
-    }
-  } else {
-    _parent = _current;
-    _current = _current->p_right_;
-    while (_current != nullptr && _current->p_left_ != nullptr) {
-      _current = _current->p_left_;
-      _parent = _current->p_parent_;
-    }
-  }
+  _current = _current->p_next_;
   return *this;
 }
 
-bool SelfBalancingBinarySearchTree::iterator::operator!=(
-    const SetIterator& other) {
-  return _current != other._current;
+typename SelfBalancingBinarySearchTree::SetIterator&
+SelfBalancingBinarySearchTree::iterator::operator--() {
+  if (_current == nullptr) {
+    throw std::invalid_argument("operator-- all is nullptr");
+  }
+  _current = _current->p_prev_;
+  return *this;
 }
 
-void SelfBalancingBinarySearchTree::iterator::ChangeIterPos(Node* other) {
-  _current = other;
-  _parent = other->p_parent_;
+Peer& SelfBalancingBinarySearchTree::iterator::operator*() {
+  return _current->kV_;
 }
 
-int SelfBalancingBinarySearchTree::MaxDepth(Node* node) {
-  if (node == nullptr) {
-    return (-1);
-  } else {
-    int leftDepth = MaxDepth(node->p_left_);
-    int rightDepth = MaxDepth(node->p_right_);
-    if (leftDepth > rightDepth)
-      return (leftDepth + 1);
-    else
-      return (rightDepth + 1);
-  }
+bool SelfBalancingBinarySearchTree::iterator::operator!=(
+    const SetIterator& other) {
+  return _current != other._current;
 }
 
+// Высота, баланс и размер поддерева узла считаются по уже известным
+// значениям детей за O(1). Balancing проходит весь путь до корня, поэтому
+// размеры поддеревьев остаются верными после вставки и удаления.
 void SelfBalancingBinarySearchTree::ChangeBalanceToCurrentNode(Node* curNode) {
   if (curNode != nullptr) {
-    if (curNode->p_left_ == nullptr) {
-      curNode->left_deph_ = 0;
-    } else {
-      curNode->left_deph_ = (MaxDepth(curNode->p_left_) * -1) - 1;
-    }
-    if (curNode->p_right_ == nullptr) {
-      curNode->right_deph_ = 0;
-    } else {
-      curNode->right_deph_ = MaxDepth(curNode->p_right_) + 1;
-    }
-    curNode->balance_ = curNode->left_deph_ + curNode->right_deph_;
+    int left = Height(curNode->p_left_);
+    int right = Height(curNode->p_right_);
+    curNode->height_ = (left > right ? left : right) + 1;
+    curNode->balance_ = right - left;
+    curNode->count_ = Count(curNode->p_left_) + Count(curNode->p_right_) + 1;
   }
 }
 
+// Поднимается от node к корню, пересчитывая высоты и выполняя повороты.
+// Каждый шаг стоит O(1), поэтому вставка и удаление обходятся в O(log n),
+// а высота дерева не превышает 1.44 * log2(n).
 void SelfBalancingBinarySearchTree::Balancing(Node* node) {
   while (node != nullptr) {
-    if (node->p_left_ != nullptr) {
-      node->left_deph_ =
-          (node->p_left_->left_deph_ * -1) >= node->p_left_->right_deph_
-              ? node->p_left_->left_deph_ - 1
-              : (-1 * node->p_left_->right_deph_) - 1;
-    } else {
-      node->left_deph_ = 0;
-    }
-    if (node->p_right_ != nullptr) {
-      node->right_deph_ =
-          (node->p_right_->left_deph_ * -1) >= node->p_right_->right_deph_
-              ? (node->p_right_->left_deph_ * -1) + 1
-              : node->p_right_->right_deph_ + 1;
-    } else {
-      node->right_deph_ = 0;
-    }
-    node->balance_ = node->left_deph_ + node->right_deph_;
+    ChangeBalanceToCurrentNode(node);
     if (node->balance_ == -2 && node->p_left_->balance_ <= 0) {
       RightTurn(node);
     } else if (node->balance_ == -2 && node->p_left_->balance_ > 0) {
@@ -257,28 +180,123 @@ void SelfBalancingBinarySearchTree::Balancing(Node* node) {
   }
 }
 
-void SelfBalancingBinarySearchTree::AddNode(Node* node, Peer a, iterator& it) {
-  if (node->kV_ > a) {
-    if (node->p_left_ == nullptr) {
-      Node* bufL = new Node(a, node);
-      node->p_left_ = bufL;
-      Balancing(node->p_left_);
-      it.ChangeIterPos(bufL);
-      ++size_;
+// Первый узел с ключом не меньше key.
+typename SelfBalancingBinarySearchTree::Node*
+SelfBalancingBinarySearchTree::LowerBound(const std::string& key) const {
+  Node* result = nullptr;
+  Node* buf = head_node_;
+  while (buf != nullptr) {
+    if (buf->kV_.key.Compare(key) >= 0) {
+      result = buf;
+      buf = buf->p_left_;
+    } else {
+      buf = buf->p_right_;
+    }
+  }
+  return result;
+}
+
+// Последний узел с ключом меньше key; для пустого key - наибольший узел.
+typename SelfBalancingBinarySearchTree::Node*
+SelfBalancingBinarySearchTree::LastBefore(const std::string& key) const {
+  if (key.empty()) return last_node_;
+  Node* result = nullptr;
+  Node* buf = head_node_;
+  while (buf != nullptr) {
+    if (buf->kV_.key.Compare(key) < 0) {
+      result = buf;
+      buf = buf->p_right_;
+    } else {
+      buf = buf->p_left_;
+    }
+  }
+  return result;
+}
+
+// Число узлов с ключом меньше key.
+size_t SelfBalancingBinarySearchTree::RankOf(const std::string& key) const {
+  size_t rank = 0;
+  Node* buf = head_node_;
+  while (buf != nullptr) {
+    if (buf->kV_.key.Compare(key) < 0) {
+      rank += Count(buf->p_left_) + 1;
+      buf = buf->p_right_;
     } else {
-      AddNode(node->p_left_, a, it);
+      buf = buf->p_left_;
     }
-  } else if (node->kV_ < a) {
-    if (node->p_right_ == nullptr) {
-      Node* bufR = new Node(a, node);
-      node->p_right_ = bufR;
-      Balancing(node->p_right_);
-      it.ChangeIterPos(bufR);
-      ++size_;
+  }
+  return rank;
+}
+
+// Узел с номером index в порядке ключей.
+typename SelfBalancingBinarySearchTree::Node*
+SelfBalancingBinarySearchTree::SelectNode(size_t index) const {
+  Node* buf = head_node_;
+  while (buf != nullptr) {
+    size_t left = Count(buf->p_left_);
+    if (index == left) break;
+    if (index < left) {
+      buf = buf->p_left_;
     } else {
-      AddNode(node->p_right_, a, it);
+      index -= left + 1;
+      buf = buf->p_right_;
     }
   }
+  return buf;
+}
+
+// Место ключа в дереве: ссылка на узел с этим ключом или на пустое место,
+// куда его следует подвесить; в parent - родитель этого места.
+typename SelfBalancingBinarySearchTree::Node**
+SelfBalancingBinarySearchTree::FindLink(std::string_view key, Node** parent) {
+  *parent = nullptr;
+  Node** link = &head_node_;
+  while (*link != nullptr) {
+    int cmp = (*link)->kV_.key.Compare(key);
+    if (cmp == 0) break;
+    *parent = *link;
+    link = cmp > 0 ? &(*parent)->p_left_ : &(*parent)->p_right_;
+  }
+  return link;
+}
+
+// Один спуск от корня: сравнение с каждым узлом пути выполняется один раз,
+// запись перемещается в новый узел без копирования. Истёкшая запись с тем
+// же ключом удаляется и спуск повторяется.
+typename SelfBalancingBinarySearchTree::Node*
+SelfBalancingBinarySearchTree::InsertNode(Peer&& peer) {
+  Node* parent;
+  Node** link = FindLink(peer.key.View(), &parent);
+  if (*link != nullptr) {
+    if (!Expirer::Expired((*link)->deadline_, Expirer::NowMs())) {
+      return nullptr;
+    }
+    Erase(*link);
+    return InsertNode(std::move(peer));
+  }
+  Node* node = nodes_.New(std::move(peer));
+  Attach(node, parent, link);
+  return node;
+}
+
+// Подвешивает отдельный узел на пустое место link под parent.
+void SelfBalancingBinarySearchTree::Attach(Node* node, Node* parent,
+                                           Node** link) {
+  node->p_parent_ = parent;
+  node->p_left_ = node->p_right_ = nullptr;
+  node->balance_ = 0;
+  node->height_ = 1;
+  node->count_ = 1;
+  *link = node;
+  if (parent == nullptr) {
+    Link(node, nullptr, nullptr);
+  } else if (link == &parent->p_left_) {
+    Link(node, parent->p_prev_, parent);
+  } else {
+    Link(node, parent, parent->p_next_);
+  }
+  ++size_;
+  Balancing(parent);
 }
 
 void SelfBalancingBinarySearchTree::LeftTurn(Node* node) {
@@ -352,10 +370,11 @@ SelfBalancingBinarySearchTree::FindNode(const std::string& key) {
   Node* buf = head_node_;
   bool res = false;
   while (buf != nullptr) {
-    if (buf->kV_.key == key) {
+    int cmp = buf->kV_.key.Compare(key);
+    if (cmp == 0) {
       res = true;
       break;
-    } else if (key > buf->kV_.key) {
+    } else if (cmp < 0) {
       buf = buf->p_right_;
     } else {
       buf = buf->p_left_;
@@ -365,29 +384,73 @@ SelfBalancingBinarySearchTree::FindNode(const std::string& key) {
 }
 
 void SelfBalancingBinarySearchTree::Erase(Node* node) {
-  if (node->p_parent_ == nullptr) {
-    EraseHead(node);
-  } else {
-    EraseLeftOrRightParents(node);
-  }
+  Untrack(node->kV_);
+  Detach(node);
+  nodes_.Delete(node);
 }
 
-auto SelfBalancingBinarySearchTree::UpdateTimer() -> void {
-  auto start = std::chrono::system_clock::now();
-  auto iter = timer_.begin();
-  while (iter != timer_.end()) {
-    if (!(*iter).first ||
-        ((*iter).second -=
-         std::chrono::duration_cast<std::chrono::seconds>(start - old_time_)
-             .count()) <= 0) {
-      Erase((*iter).first);
-
-      iter = timer_.erase(iter);
+// Узел с двумя детьми заменяется своим преемником: преемник
+// перевешивается на его место, данные записей не копируются, и указатели
+// на остальные записи остаются действительными. Балансировка идёт снизу
+// вверх от места, где поддерево стало ниже. Сам узел не освобождается.
+void SelfBalancingBinarySearchTree::Detach(Node* node) {
+  Node* rebalance_from = node->p_parent_;
+  if (node->p_left_ != nullptr && node->p_right_ != nullptr) {
+    Node* successor = node->p_next_;
+    if (successor->p_parent_ != node) {
+      rebalance_from = successor->p_parent_;
+      ReplaceChild(successor->p_parent_, successor, successor->p_right_);
+      successor->p_right_ = node->p_right_;
+      successor->p_right_->p_parent_ = successor;
     } else {
-      ++iter;
+      rebalance_from = successor;
     }
+    ReplaceChild(node->p_parent_, node, successor);
+    successor->p_left_ = node->p_left_;
+    successor->p_left_->p_parent_ = successor;
+  } else {
+    ReplaceChild(node->p_parent_, node,
+                 node->p_left_ != nullptr ? node->p_left_ : node->p_right_);
+  }
+  Unlink(node);
+  --size_;
+  Balancing(rebalance_from);
+}
+
+typename SelfBalancingBinarySearchTree::Node*
+SelfBalancingBinarySearchTree::FindLiveNode(const std::string& key) {
+  Node* node = FindNode(key);
+  if (node && Expirer::Expired(node->deadline_, Expirer::NowMs())) {
+    Erase(node);
+    return nullptr;
   }
-  old_time_ = start;
+  return node;
+}
+
+auto SelfBalancingBinarySearchTree::Reclaim(const std::string& key,
+                                            int64_t deadline) -> bool {
+  Node* node = FindNode(key);
+  if (!node || node->deadline_ != deadline) return false;
+  Erase(node);
+  return true;
+}
+
+auto SelfBalancingBinarySearchTree::Tick() -> void {
+  expiry_.Tick([this](const std::string& key, int64_t deadline) {
+    return Reclaim(key, deadline);
+  });
+}
+
+auto SelfBalancingBinarySearchTree::ReclaimDue() -> void {
+  expiry_.Drain([this](const std::string& key, int64_t deadline) {
+    return Reclaim(key, deadline);
+  });
+}
+
+auto SelfBalancingBinarySearchTree::SetDeadline(Node* node, int64_t deadline)
+    -> void {
+  node->deadline_ = deadline;
+  expiry_.Schedule(node->kV_.key, deadline);
 }
 
 }  //  namespace s21
@@ -1,53 +1,34 @@
 #include <algorithm>
 
+#include "../other/record_loader.h"
 #include "self_balancing_binary_search_tree.h"
 
 namespace s21 {
 
-auto SelfBalancingBinarySearchTree::Set(const Peer &peer, int time_of_life)
-    -> void {
-  UpdateTimer();
+auto SelfBalancingBinarySearchTree::Set(Peer peer, int time_of_life) -> void {
+  Tick();
   if (size_ == MaxSize()) throw std::out_of_range("ERROR: Tree if full");
-  iterator it;
-  if (head_node_ == nullptr) {
-    head_node_ = new Node(peer);
-    ++size_;
-    if (time_of_life > 0)
-      timer_.push_back(std::pair<Node *, time_t>{head_node_, time_of_life});
-  } else {
-    if (!FindNode(peer.key)) {
-      AddNode(head_node_, peer, it);
-      if (time_of_life > 0)
-        timer_.push_back(std::pair<Node *, time_t>{it._current, time_of_life});
-    }
-  }
+  Node *node = InsertNode(std::move(peer));
+  if (node == nullptr) return;
+  Track(node->kV_);
+  if (time_of_life > 0)
+    SetDeadline(node, Expirer::NowMs() + time_of_life * 1000LL);
 }
 
 auto SelfBalancingBinarySearchTree::Get(const std::string &key) -> Peer * {
-  UpdateTimer();
-  Node *buf = head_node_;
-  bool res = false;
-  while (buf != nullptr) {
-    if (buf->kV_.key == key) {
-      res = true;
-      break;
-    } else if (key > buf->kV_.key) {
-      buf = buf->p_right_;
-    } else {
-      buf = buf->p_left_;
-    }
-  }
-  return res ? &buf->kV_ : nullptr;
+  Tick();
+  Node *node = FindLiveNode(key);
+  return node ? &node->kV_ : nullptr;
 }
 
 auto SelfBalancingBinarySearchTree::Exists(const std::string &key) -> bool {
-  UpdateTimer();
-  return Get(key) != nullptr;
+  Tick();
+  return FindLiveNode(key) != nullptr;
 }
 
 auto SelfBalancingBinarySearchTree::Del(const std::string &key) -> bool {
-  UpdateTimer();
-  Node *pos = FindNode(key);
+  Tick();
+  Node *pos = FindLiveNode(key);
   if (pos) {
     Erase(pos);
     return true;
@@ -59,48 +40,128 @@ auto SelfBalancingBinarySearchTree::Update(
     const std::string &key, const std::string &last_name,
     const std::string &first_name, int year_of_birth, const std::string &city,
     int number_of_current_coins) -> void {
-  UpdateTimer();
-  Node *node = FindNode(key);
+  Tick();
+  Node *node = FindLiveNode(key);
   if (node) {
+    Untrack(node->kV_);
     if (!last_name.empty()) node->kV_.last_name = last_name;
     if (!first_name.empty()) node->kV_.first_name = first_name;
     if (year_of_birth) node->kV_.year_of_birth = year_of_birth;
     if (!city.empty()) node->kV_.city = city;
     //    if (number_of_current_coins)
     node->kV_.number_of_current_coins = number_of_current_coins;
+    Track(node->kV_);
   }
 }
 
-auto SelfBalancingBinarySearchTree::Keys() -> std::vector<std::string> {
-  UpdateTimer();
-  std::vector<std::string> result;
-  result.reserve(size_);
+// Обходит живые записи по возрастанию ключа; истёкшие, но ещё не удалённые
+// записи пропускаются.
+template <typename Func>
+void SelfBalancingBinarySearchTree::ForEach(Func func) {
+  int64_t now = Expirer::NowMs();
   iterator iter = begin();
   iterator iend = end();
   while (iter != iend) {
-    result.push_back(iter._current->kV_.key);
+    if (!Expirer::Expired(iter._current->deadline_, now))
+      func(iter._current->kV_);
     ++iter;
   }
-  return result;
 }
 
+// Полный обход, разделённый на отрезки по номерам узлов: начало отрезка
+// находится по размерам поддеревьев, дальше узлы идут по списку.
+// func(peer, &out) добавляет результаты записи в вектор своего отрезка.
+template <typename T, typename Func>
+auto SelfBalancingBinarySearchTree::Collect(Func func) -> std::vector<T> {
+  size_t parts = std::clamp<size_t>(size_ / kMinScanPart, 1, scan_parts_);
+  int64_t now = Expirer::NowMs();
+  return WorkerPool::Instance().Gather<T>(
+      parts, [this, parts, now, &func](size_t part, std::vector<T> *out) {
+        size_t end = size_ * (part + 1) / parts;
+        Node *node = SelectNode(size_ * part / parts);
+        for (size_t i = size_ * part / parts; i < end; ++i) {
+          if (!Expirer::Expired(node->deadline_, now)) func(node->kV_, out);
+          node = node->p_next_;
+        }
+      });
+}
+
+auto SelfBalancingBinarySearchTree::Keys() -> std::vector<std::string> {
+  Tick();
+  return Collect<std::string>([](Peer &peer, std::vector<std::string> *out) {
+    out->push_back(peer.key);
+  });
+}
+
+// Узел снимается с дерева и подвешивается заново под новым ключом: запись
+// не копируется и не переразмещается, срок жизни остаётся при ней. Живая
+// запись с ключом key_new заменяется, как RENAME в Redis.
 auto SelfBalancingBinarySearchTree::Rename(const std::string &key_old,
                                            const std::string &key_new) -> void {
-  UpdateTimer();
-  Node *node = FindNode(key_old);
-  if (node) {
-    node->kV_.key = key_new;
-  }
+  Tick();
+  if (key_old == key_new) return;
+  Node *target = FindLiveNode(key_new);
+  Node *node = FindLiveNode(key_old);
+  if (!node) return;
+  if (target) Erase(target);
+  Untrack(node->kV_);
+  Detach(node);
+  node->kV_.key = key_new;
+  Node *parent;
+  Node **link = FindLink(node->kV_.key.View(), &parent);
+  Attach(node, parent, link);
+  Track(node->kV_);
+  SetDeadline(node, node->deadline_);
 }
 
 auto SelfBalancingBinarySearchTree::TTL(const std::string &key) -> int {
-  UpdateTimer();
-  auto itr = std::find_if(timer_.begin(), timer_.end(),
-                          [key](const std::pair<Node *, time_t> &a) {
-                            return key == a.first->kV_.key;
-                          });
-  if (itr != timer_.end()) return (int)itr->second;
-  return 0;
+  Tick();
+  Node *node = FindLiveNode(key);
+  if (!node || !node->deadline_) return 0;
+  return static_cast<int>((node->deadline_ - Expirer::NowMs() + 999) /
+                          1000);
+}
+
+auto SelfBalancingBinarySearchTree::Expire(const std::string &key, int seconds)
+    -> bool {
+  return PExpireAt(key, Expirer::NowMs() + std::max(seconds, 0) * 1000LL);
+}
+
+auto SelfBalancingBinarySearchTree::Persist(const std::string &key) -> bool {
+  Tick();
+  Node *node = FindLiveNode(key);
+  if (!node || !node->deadline_) return false;
+  SetDeadline(node, 0);
+  return true;
+}
+
+auto SelfBalancingBinarySearchTree::PTTL(const std::string &key) -> int64_t {
+  Tick();
+  Node *node = FindLiveNode(key);
+  if (!node) return -2;
+  if (!node->deadline_) return -1;
+  return std::max<int64_t>(0, node->deadline_ - Expirer::NowMs());
+}
+
+auto SelfBalancingBinarySearchTree::PExpireTime(const std::string &key)
+    -> int64_t {
+  Tick();
+  Node *node = FindLiveNode(key);
+  if (!node) return -2;
+  return node->deadline_ ? node->deadline_ : -1;
+}
+
+auto SelfBalancingBinarySearchTree::PExpireAt(const std::string &key,
+                                              int64_t deadline) -> bool {
+  Tick();
+  Node *node = FindLiveNode(key);
+  if (!node) return false;
+  if (Expirer::Expired(deadline, Expirer::NowMs())) {
+    Erase(node);
+  } else {
+    SetDeadline(node, deadline);
+  }
+  return true;
 }
 
 auto SelfBalancingBinarySearchTree::Find(const std::string &last_name,
@@ -109,83 +170,166 @@ auto SelfBalancingBinarySearchTree::Find(const std::string &last_name,
                                          const std::string &city,
                                          int number_of_current_coins)
     -> std::vector<std::string> {
-  UpdateTimer();
+  Tick();
   std::vector<std::string> result;
-  iterator iter = begin();
-  iterator iend = end();
-  while (iter != iend) {
-    if ((last_name.empty() || iter._current->kV_.last_name == last_name) &&
-        (first_name.empty() || iter._current->kV_.first_name == first_name) &&
-        (!year_of_birth || iter._current->kV_.year_of_birth == year_of_birth) &&
-        (city.empty() || iter._current->kV_.city == city) &&
-        (number_of_current_coins == -1 ||
-         iter._current->kV_.number_of_current_coins ==
-             number_of_current_coins)) {
-      result.push_back(iter._current->kV_.key);
+  PeerFilter filter(last_name, first_name, year_of_birth, city,
+                    number_of_current_coins);
+  if (filter.Selective() && (indexing_ || columnar_)) {
+    auto candidates =
+        indexing_ ? index_.Find(filter) : columns_.Find(filter);
+    for (const std::string &key : candidates) {
+      if (FindLiveNode(key)) result.push_back(key);
     }
-    ++iter;
+    std::sort(result.begin(), result.end());
+    return result;
   }
-  return result;
+  if (filter.Impossible()) return result;
+  return Collect<std::string>(
+      [&filter](Peer &peer, std::vector<std::string> *out) {
+        if (filter(peer)) out->push_back(peer.key);
+      });
 }
 
-auto SelfBalancingBinarySearchTree::ShowAll() -> std::vector<Peer *> {
-  UpdateTimer();
-  std::vector<Peer *> result;
-  result.reserve(size_);
-  iterator iter = begin();
-  iterator iend = end();
-  while (iter != iend) {
-    result.push_back(&iter._current->kV_);
-    ++iter;
+auto SelfBalancingBinarySearchTree::ScanRange(const std::string &from,
+                                              const std::string &to,
+                                              const Visitor &visit,
+                                              bool reverse) -> void {
+  Tick();
+  int64_t now = Expirer::NowMs();
+  auto live = [now](const Node *node) {
+    return !Expirer::Expired(node->deadline_, now);
+  };
+  if (reverse) {
+    for (Node *node = LastBefore(to);
+         node != nullptr && node->kV_.key.Compare(from) >= 0;
+         node = node->p_prev_) {
+      if (live(node) && !visit(node->kV_)) break;
+    }
+  } else {
+    for (Node *node = LowerBound(from);
+         node != nullptr && (to.empty() || node->kV_.key.Compare(to) < 0);
+         node = node->p_next_) {
+      if (live(node) && !visit(node->kV_)) break;
+    }
+  }
+}
+
+auto SelfBalancingBinarySearchTree::Keys(size_t offset, size_t limit)
+    -> std::vector<std::string> {
+  ReclaimDue();
+  std::vector<std::string> result;
+  int64_t now = Expirer::NowMs();
+  for (Node *node = SelectNode(offset);
+       node != nullptr && (limit == 0 || result.size() < limit);
+       node = node->p_next_) {
+    if (!Expirer::Expired(node->deadline_, now))
+      result.push_back(node->kV_.key);
   }
   return result;
 }
 
+auto SelfBalancingBinarySearchTree::Rank(const std::string &key) -> size_t {
+  ReclaimDue();
+  return RankOf(key);
+}
+
+auto SelfBalancingBinarySearchTree::Select(size_t index) -> Peer * {
+  ReclaimDue();
+  Node *node = SelectNode(index);
+  return node ? &node->kV_ : nullptr;
+}
+
+auto SelfBalancingBinarySearchTree::CountRange(const std::string &from,
+                                               const std::string &to)
+    -> size_t {
+  ReclaimDue();
+  size_t begin = RankOf(from);
+  size_t end = to.empty() ? size_ : RankOf(to);
+  return end > begin ? end - begin : 0;
+}
+
+auto SelfBalancingBinarySearchTree::ShowAll() -> std::vector<Peer *> {
+  Tick();
+  return Collect<Peer *>(
+      [](Peer &peer, std::vector<Peer *> *out) { out->push_back(&peer); });
+}
+
+auto SelfBalancingBinarySearchTree::SetParallelScan(size_t parts) -> bool {
+  scan_parts_ = parts ? parts : WorkerCount();
+  return true;
+}
+
+auto SelfBalancingBinarySearchTree::SetColumnar(bool enable) -> bool {
+  columnar_ = enable;
+  columns_.Clear();
+  if (enable) ForEach([this](const Peer &peer) { columns_.Insert(peer); });
+  return true;
+}
+
+auto SelfBalancingBinarySearchTree::Track(const Peer &peer) -> void {
+  if (indexing_) index_.Insert(peer);
+  if (columnar_) columns_.Insert(peer);
+}
+
+auto SelfBalancingBinarySearchTree::Untrack(const Peer &peer) -> void {
+  if (indexing_) index_.Erase(peer);
+  if (columnar_) columns_.Erase(peer.key);
+}
+
+auto SelfBalancingBinarySearchTree::SetIndexing(bool enable) -> bool {
+  indexing_ = enable;
+  index_.Clear();
+  if (enable) ForEach([this](const Peer &peer) { index_.Insert(peer); });
+  return true;
+}
+
+// Файл разбирается параллельно по кускам. В пустое дерево записи
+// загружаются целиком через BulkLoad; в непустое добавляются по одной.
 auto SelfBalancingBinarySearchTree::Upload(const std::string &data_directory)
     -> int {
-  UpdateTimer();
-  std::ifstream file(data_directory);
-  int lines = 0;
-  if (file.is_open()) {
-    char c;
-    while ((c = file.get()) != EOF) {
-      if (c == '\n') ++lines;
-    }
-    file.clear();
-    file.seekg(0, std::ios_base::beg);
-    for (int i = 0; i < lines; ++i) {
-      Peer peer;
-      file >> peer.key;
-      file >> peer.last_name;
-      file >> peer.first_name;
-      file >> peer.year_of_birth;
-      file >> peer.city;
-      file >> peer.number_of_current_coins;
-      Set(peer);
-    }
-    file.close();
+  Tick();
+  auto batches = ParseRecords(data_directory);
+  if (batches.empty()) return 0;
+  int lines = RecordCount(batches);
+  std::vector<Peer> peers = std::move(batches.front());
+  peers.reserve(lines);
+  for (size_t i = 1; i < batches.size(); ++i) {
+    std::move(batches[i].begin(), batches[i].end(), std::back_inserter(peers));
+  }
+  if (head_node_ == nullptr) {
+    BulkLoad(std::move(peers));
+  } else {
+    for (Peer &peer : peers) Set(std::move(peer));
   }
   return lines;
 }
 
 auto SelfBalancingBinarySearchTree::ExportData(
     const std::string &data_directory) -> int {
-  UpdateTimer();
+  Tick();
   std::ofstream file(data_directory);
-  iterator iter = begin();
-  iterator iend = end();
+  int lines = 0;
   if (file.is_open()) {
-    while (iter != iend) {
-      file << iter._current->kV_.key << " ";
-      file << iter._current->kV_.last_name << " ";
-      file << iter._current->kV_.first_name << " ";
-      file << iter._current->kV_.year_of_birth << " ";
-      file << iter._current->kV_.city << " ";
-      file << iter._current->kV_.number_of_current_coins << "\n";
-      ++iter;
-    }
+    ForEach([&file, &lines](const Peer &peer) {
+      file << peer.key << " ";
+      file << peer.last_name << " ";
+      file << peer.first_name << " ";
+      file << peer.year_of_birth << " ";
+      file << peer.city << " ";
+      file << peer.number_of_current_coins << "\n";
+      ++lines;
+    });
   }
-  return size_;
+  return lines;
+}
+
+auto SelfBalancingBinarySearchTree::ActiveExpireCycle(
+    std::chrono::microseconds budget) -> size_t {
+  return expiry_.Cycle(
+      [this](const std::string &key, int64_t deadline) {
+        return Reclaim(key, deadline);
+      },
+      budget);
 }
 
 }  // namespace s21
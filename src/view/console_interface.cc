@@ -1,6 +1,7 @@
 #include "console_interface.h"
 
 #include <algorithm>
+#include <chrono>
 #include <sstream>
 
 ConsoleInterface::ConsoleInterface() {
@@ -14,7 +15,10 @@ auto ConsoleInterface::MainMenu() -> void {
 
   cout << "\t\t" << header_style_ << "TRANSACTIONS\n" << ClearStyle << endl;
   cout << "Chose chose type of storage:" << endl;
-  cout << "1. Hast Table\n2. Self Balancing Binary Search Tree" << endl;
+  cout << "1. Hast Table\n2. Self Balancing Binary Search Tree\n3. B+ Tree\n"
+          "4. Sharded Hash Table\n5. Concurrent Hash Table\n"
+          "6. Concurrent B+ Tree"
+       << endl;
   cout << "q for exit" << endl;
   //  system("stty raw");
   while (true) {
@@ -28,6 +32,23 @@ auto ConsoleInterface::MainMenu() -> void {
       storage = std::make_unique<s21::SelfBalancingBinarySearchTree>();
       cout << "Tree" << endl;
       break;
+    } else if (in == '3') {
+      storage = std::make_unique<s21::BPlusTree>();
+      cout << "B+ Tree" << endl;
+      break;
+    } else if (in == '4') {
+      storage = std::make_unique<s21::ShardedKeyValue>(
+          [] { return std::make_unique<s21::HashTable>(); });
+      cout << "Sharded HashTable" << endl;
+      break;
+    } else if (in == '5') {
+      storage = std::make_unique<s21::ConcurrentHashTable>();
+      cout << "Concurrent HashTable" << endl;
+      break;
+    } else if (in == '6') {
+      storage = std::make_unique<s21::ConcurrentBPlusTree>();
+      cout << "Concurrent B+ Tree" << endl;
+      break;
     } else if (in == 'q') {
       storage = nullptr;
       break;
@@ -67,10 +88,26 @@ auto ConsoleInterface::CommandHandler() -> void {
         Rename(args);
       else if (command == "ttl")
         TTL(args);
+      else if (command == "expire")
+        Expire(args);
+      else if (command == "persist")
+        Persist(args);
+      else if (command == "pttl")
+        PTTL(args);
       else if (command == "find")
         Find(args);
       else if (command == "showall")
         ShowAll(args);
+      else if (command == "scan")
+        Scan(args);
+      else if (command == "range")
+        Range(args);
+      else if (command == "index")
+        Index(args);
+      else if (command == "columnar")
+        Columnar(args);
+      else if (command == "parallel")
+        Parallel(args);
       else if (command == "upload")
         Upload(args);
       else if (command == "export")
@@ -202,11 +239,21 @@ auto ConsoleInterface::Update(std::vector<std::string>& args) -> void {
   std::cout << "> " << green << "OK" << ClearStyle << std::endl;
 }
 
+// keys [offset limit] - страница ключей по порядку для упорядоченных
+// хранилищ.
 auto ConsoleInterface::Keys(const std::vector<std::string>& args) -> void {
-  if (!args.empty()) throw std::invalid_argument("ERROR: too much arguments");
-  unsigned count = 1;
-  for (const auto& key : storage->Keys())
-    std::cout << count++ << ") " << key << std::endl;
+  if (args.size() != 0 and args.size() != 2)
+    throw std::invalid_argument("ERROR: only 0 or 2 arguments are accepted");
+  for (const auto& arg : args) {
+    if (arg.empty() or !std::all_of(arg.begin(), arg.end(), isdigit))
+      throw std::invalid_argument(
+          {"ERROR: unable to cast value \"" + arg + "\" to type int"});
+  }
+  size_t offset = args.empty() ? 0 : std::stoul(args[0]);
+  auto keys = args.empty() ? storage->Keys()
+                           : Ordered()->Keys(offset, std::stoul(args[1]));
+  size_t count = offset + 1;
+  for (const auto& key : keys) std::cout << count++ << ") " << key << std::endl;
   std::cout << std::endl;
 }
 
@@ -233,6 +280,39 @@ auto ConsoleInterface::TTL(const std::vector<std::string>& args) -> void {
     std::cout << "> " << red << "(null)" << ClearStyle << std::endl;
 }
 
+auto ConsoleInterface::Expire(const std::vector<std::string>& args) -> void {
+  if (args.size() != 2)
+    throw std::invalid_argument("ERROR: only 2 arguments are accepted");
+  if (!std::all_of(args[1].begin(), args[1].end(), isdigit))
+    throw std::invalid_argument(
+        {"ERROR: unable to cast value \"" + args[1] + "\" to type int"});
+  if (storage->Expire(args[0], std::stoi(args[1])))
+    std::cout << "> " << green << true << ClearStyle << std::endl;
+  else
+    std::cout << "> " << red << false << ClearStyle << std::endl;
+}
+
+auto ConsoleInterface::Persist(const std::vector<std::string>& args) -> void {
+  if (args.size() != 1)
+    throw std::invalid_argument("ERROR: only 1 argument are accepted");
+  if (storage->Persist(args[0]))
+    std::cout << "> " << green << true << ClearStyle << std::endl;
+  else
+    std::cout << "> " << red << false << ClearStyle << std::endl;
+}
+
+auto ConsoleInterface::PTTL(const std::vector<std::string>& args) -> void {
+  if (args.size() != 1)
+    throw std::invalid_argument("ERROR: only 1 argument are accepted");
+  int64_t pttl = storage->PTTL(args[0]);
+  if (pttl == -2)
+    std::cout << "> " << red << "(null)" << ClearStyle << std::endl;
+  else if (pttl == -1)
+    std::cout << "> " << green << "inf" << ClearStyle << std::endl;
+  else
+    std::cout << "> " << red << pttl << ClearStyle << std::endl;
+}
+
 auto ConsoleInterface::Find(std::vector<std::string>& args) -> void {
   if (args.size() < 5) args.resize(5, "");
   CleanSkippedArgs(args);
@@ -257,10 +337,108 @@ auto ConsoleInterface::ShowAll(const std::vector<std::string>& args) -> void {
               << p->city << "\"\t" << p->number_of_current_coins << std::endl;
 }
 
+auto ConsoleInterface::Ordered() -> OrderedKeyValue* {
+  auto ordered = dynamic_cast<OrderedKeyValue*>(storage.get());
+  if (!ordered)
+    throw std::invalid_argument("ERROR: storage keeps no key order");
+  return ordered;
+}
+
+// Необязательные хвостовые аргументы: [limit] [desc].
+auto ConsoleInterface::ParseScanTail(const std::vector<std::string>& args,
+                                     size_t from, size_t* limit,
+                                     bool* reverse) -> void {
+  if (args.size() > from + 2)
+    throw std::invalid_argument("ERROR: too much arguments");
+  *limit = 0;
+  *reverse = false;
+  for (size_t i = from; i < args.size(); ++i) {
+    if (args[i] == "desc" or args[i] == "DESC") {
+      *reverse = true;
+    } else if (i == from and !args[i].empty() and
+               std::all_of(args[i].begin(), args[i].end(), isdigit)) {
+      *limit = std::stoul(args[i]);
+    } else {
+      throw std::invalid_argument(
+          {"ERROR: wrong arg \"" + args[i] + R"(" expected limit or "desc")"});
+    }
+  }
+}
+
+auto ConsoleInterface::PrintKeys(const std::vector<std::string>& keys)
+    -> void {
+  unsigned count = 1;
+  for (const auto& key : keys) std::cout << count++ << ") " << key << std::endl;
+  std::cout << std::endl;
+}
+
+auto ConsoleInterface::Scan(const std::vector<std::string>& args) -> void {
+  if (args.empty()) throw std::invalid_argument("ERROR: prefix is required");
+  size_t limit;
+  bool reverse;
+  ParseScanTail(args, 1, &limit, &reverse);
+  std::string prefix = args[0] == "-" ? "" : args[0];
+  PrintKeys(Ordered()->ScanPrefix(prefix, limit, reverse));
+}
+
+auto ConsoleInterface::Range(const std::vector<std::string>& args) -> void {
+  if (args.size() < 2)
+    throw std::invalid_argument("ERROR: from and to are required");
+  size_t limit;
+  bool reverse;
+  ParseScanTail(args, 2, &limit, &reverse);
+  std::string from = args[0] == "-" ? "" : args[0];
+  std::string to = args[1] == "-" ? "" : args[1];
+  PrintKeys(Ordered()->Scan(from, to, limit, reverse));
+}
+
+auto ConsoleInterface::CheckSwitch(const std::vector<std::string>& args)
+    -> bool {
+  if (args.size() != 1 or (args[0] != "on" and args[0] != "off"))
+    throw std::invalid_argument(R"(ERROR: argument can only be "on/off")");
+  return args[0] == "on";
+}
+
+auto ConsoleInterface::Index(const std::vector<std::string>& args) -> void {
+  if (storage->SetIndexing(CheckSwitch(args)))
+    std::cout << "> " << green << "OK" << ClearStyle << std::endl;
+  else
+    std::cout << "> " << red << "not supported" << ClearStyle << std::endl;
+}
+
+auto ConsoleInterface::Columnar(const std::vector<std::string>& args)
+    -> void {
+  if (storage->SetColumnar(CheckSwitch(args)))
+    std::cout << "> " << green << "OK" << ClearStyle << std::endl;
+  else
+    std::cout << "> " << red << "not supported" << ClearStyle << std::endl;
+}
+
+auto ConsoleInterface::Parallel(const std::vector<std::string>& args)
+    -> void {
+  if (args.size() != 1)
+    throw std::invalid_argument("ERROR: only 1 argument are accepted");
+  if (args[0].empty() or !std::all_of(args[0].begin(), args[0].end(), isdigit))
+    throw std::invalid_argument(
+        {"ERROR: unable to cast value \"" + args[0] + "\" to type int"});
+  if (storage->SetParallelScan(std::stoul(args[0])))
+    std::cout << "> " << green << "OK" << ClearStyle << std::endl;
+  else
+    std::cout << "> " << red << "not supported" << ClearStyle << std::endl;
+}
+
 auto ConsoleInterface::Upload(const std::vector<std::string>& args) -> void {
   if (args.size() != 1)
     throw std::invalid_argument("ERROR: only 1 argument are accepted");
-  std::cout << "> " << storage->Upload(args[0]) << std::endl;
+  auto start = std::chrono::steady_clock::now();
+  int rows = storage->Upload(args[0]);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << "> " << rows;
+  if (rows > 0 && elapsed.count() > 0)
+    std::cout << " (" << static_cast<int64_t>(rows / elapsed.count())
+              << " rows/s)";
+  std::cout << std::endl;
 }
 
 auto ConsoleInterface::Export(const std::vector<std::string>& args) -> void {
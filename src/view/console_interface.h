@@ -3,8 +3,13 @@
 
 #include <memory>
 
+#include "../btree/b_plus_tree.h"
+#include "../concurrent/concurrent_b_plus_tree.h"
+#include "../concurrent/concurrent_hash_table.h"
 #include "../hashtable/hash_table.h"
 #include "../other/key_value.h"
+#include "../other/ordered_key_value.h"
+#include "../sharded/sharded_key_value.h"
 #include "../tree/self_balancing_binary_search_tree.h"
 #include "console_style.h"
 
@@ -31,8 +36,21 @@ class ConsoleInterface {
   auto Keys(const std::vector<std::string> &args) -> void;
   auto Rename(const std::vector<std::string> &args) -> void;
   auto TTL(const std::vector<std::string> &args) -> void;
+  auto Expire(const std::vector<std::string> &args) -> void;
+  auto Persist(const std::vector<std::string> &args) -> void;
+  auto PTTL(const std::vector<std::string> &args) -> void;
   auto Find(std::vector<std::string> &args) -> void;
   auto ShowAll(const std::vector<std::string> &args) -> void;
+  auto Scan(const std::vector<std::string> &args) -> void;
+  auto Range(const std::vector<std::string> &args) -> void;
+  auto Ordered() -> OrderedKeyValue *;
+  static auto ParseScanTail(const std::vector<std::string> &args, size_t from,
+                            size_t *limit, bool *reverse) -> void;
+  static auto PrintKeys(const std::vector<std::string> &keys) -> void;
+  auto Index(const std::vector<std::string> &args) -> void;
+  auto Columnar(const std::vector<std::string> &args) -> void;
+  auto Parallel(const std::vector<std::string> &args) -> void;
+  static auto CheckSwitch(const std::vector<std::string> &args) -> bool;
   auto Upload(const std::vector<std::string> &args) -> void;
   auto Export(const std::vector<std::string> &args) -> void;
 